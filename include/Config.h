@@ -4,7 +4,10 @@
 #include <mutex>
 #include <string>
 #include <thread>
+#include <chrono>
 
+// READ/WRITE address models for random processes ("access-pattern")
+enum AccessPattern { ACCESS_UNIFORM, ACCESS_SEQUENTIAL, ACCESS_ZIPF, ACCESS_PHASED };
 
 // Configuration Management
 class Config {
@@ -23,6 +26,18 @@ public:
     int getMemPerFrame() const { return mem_per_frame; }
     int getMinMemPerProc() const { return mim_mem_per_proc; }
     int getMaxMemPerProc() const { return max_mem_per_prc; }
+    bool getLazyInstructions() const { return lazy_instructions; }
+    std::string getPageReplacement() const { return page_replacement; }
+    int getPrefetchPages() const { return prefetch_pages; }
+    int getFreeFramesLow() const { return free_frames_low; }
+    int getFreeFramesHigh() const { return free_frames_high; }
+    long long getSwapCacheSize() const { return swap_cache_size; }
+    int getPageFaultLatency() const { return page_fault_latency; }
+    double getMemoryOvercommit() const { return memory_overcommit; }
+    // Weights of PRINT, DECLARE, ADD, SUBTRACT, SLEEP, FOR, READ, WRITE
+    const int* getInstructionMix() const { return instruction_mix; }
+    AccessPattern getAccessPattern() const { return access_pattern; }
+    int getProcessHistory() const { return process_history; }
 
 private:
     Config() = default;
@@ -40,12 +55,24 @@ private:
     int mem_per_frame = 0;
     int mim_mem_per_proc = 0;
     int max_mem_per_prc = 0;
+    bool lazy_instructions = false;
+    std::string page_replacement = "clock";
+    int prefetch_pages = 0;
+    int free_frames_low = 0;
+    int free_frames_high = 0;
+    long long swap_cache_size = 0;
+    int page_fault_latency = 0;
+    double memory_overcommit = 0;
+    int instruction_mix[8] = { 1, 1, 1, 1, 1, 1, 1, 1 };
+    AccessPattern access_pattern = ACCESS_UNIFORM;
+    int process_history = 10000;
 };
 
 // Utility Functions
 namespace Utils {
     void clearScreen();
     std::string getTimestamp();
+    std::string formatTimestamp(std::chrono::system_clock::time_point time_point);
 }
 
 #endif // CONFIG_H
\ No newline at end of file
@@ -2,30 +2,67 @@
 #define MEMORY_MANAGER_H
 
 #include <vector>
+#include <algorithm>
 #include <unordered_map>
 #include <queue>
 #include <mutex>
+#include <shared_mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <memory>
 #include <cstdint>
 #include <string>
+#include "ReplacementPolicy.h"
+
+struct ProcessMemory;
 
 // Frame structure
 struct Frame {
     int frame_id;
     int process_id = -1;
+    ProcessMemory* owner = nullptr; // Page table of the resident page
     int page_number = -1;
     bool is_free = true;
-    uint64_t last_access_time = 0;
 
-    // [FIX]: The Frame now acts as Physical RAM.
-    // It holds the actual data, not just metadata.
-    std::vector<uint16_t> data;
+    // The frame's physical RAM is frame_id * mem_per_frame words into the
+    // MemoryManager arena (see frameData).
 };
 
 // Page Table Entry
 struct PageTableEntry {
     int frame_number = -1;
     bool valid = false;
-    uint64_t last_access_time = 0;
+    bool dirty = false;      // Written since it was loaded; swap copy (if any) is stale
+    bool referenced = false; // Accessed since it was loaded
+    int swap_entry = -1;     // Handle of this page's swap copy, -1 = none
+    bool prefetched = false; // Loaded by fault-around and not yet accessed
+};
+
+// One process's address space. Its mutex guards the page table, so
+// accesses by different processes never contend.
+struct ProcessMemory {
+    int process_id = -1;
+    int memory_size = 0;
+    int prefetch_window = 0; // Current fault-around size, adapted to hit rate
+    int page_faults = 0;
+    std::atomic<bool> released{false}; // Set by deallocateMemory; cached pointers are stale
+    std::vector<PageTableEntry> pages;
+    std::mutex mutex;
+};
+
+// Where a swapped-out page is kept
+enum SwapTier : uint8_t { SWAP_NONE, SWAP_ZERO, SWAP_CACHE, SWAP_DISK };
+
+// A swapped-out page: all zeros (no data kept), run-length compressed in
+// the in-memory swap cache, or in a slot of the swap device
+struct SwapEntry {
+    int process_id = -1;
+    int page_number = -1;
+    SwapTier tier = SWAP_NONE;
+    int disk_slot = -1;         // Kept once allocated, for later spills
+    bool raw = false;           // Cached uncompressed; RLE did not pay off
+    std::vector<uint16_t> data; // SWAP_CACHE only: (run, value) pairs or raw words
 };
 
 // Memory statistics
@@ -36,61 +73,240 @@ struct MemoryStats {
     int total_page_faults = 0;
     int total_pages_in = 0;
     int total_pages_out = 0;
+    int clean_evictions = 0; // Evicted without a write-back
+    int dirty_evictions = 0;
+    int swap_slots_total = 0;
+    int swap_slots_used = 0;
+    int swap_zero_pages = 0;        // Swapped pages stored as a flag only
+    int swap_cache_pages = 0;
+    long long swap_cache_bytes = 0; // Compressed size of the cached pages
+    long long swap_cache_limit = 0;
+    long long tlb_hits = 0;
+    long long tlb_misses = 0;
+    long long accesses = 0;          // TLB hits plus page-table accesses
+    long long eviction_ns = 0;       // Time spent choosing and evicting victims
+    long long frames_scanned = 0;    // Frames the policy examined
+    std::string replacement_policy;
+    int pages_prefetched = 0;
+    int prefetch_hits = 0;      // Prefetched pages later accessed
+    int prefetch_wasted = 0;    // Prefetched pages evicted or freed unused
+    int background_reclaims = 0; // Evictions by the reclaim thread
+    int direct_reclaims = 0;     // Evictions on a faulting core
+};
+
+// One cached (pid, page) -> frame translation
+struct TlbEntry {
+    int process_id = -1;
+    int page_number = -1;
+    int frame_id = -1;
+    bool writable = false; // PTE already dirty, so writes may hit too
+};
+
+// Per-core software TLB. Direct-mapped and guarded by its own mutex, so a
+// hit takes no page table or pool lock. Evictions and releases shoot entries
+// down under it while holding the owning process's mutex, before the frame
+// can be reused. It also caches the page tables of recently run processes,
+// so a TLB miss that hits the page table skips page_tables_mutex.
+struct alignas(64) CoreTlb {
+    static constexpr int kEntries = 64;
+    static constexpr int kProcesses = 8;
+    TlbEntry entries[kEntries];
+    std::shared_ptr<ProcessMemory> processes[kProcesses];
+    std::mutex mutex;
+    std::atomic<long long> hits{0};
+    std::atomic<long long> misses{0};
+    std::atomic<long long> table_accesses{0};
+};
+
+// Live counters behind MemoryStats, updated without any lock
+struct MemoryCounters {
+    std::atomic<int> used_frames{0};
+    std::atomic<int> free_frames{0};
+    std::atomic<int> total_page_faults{0};
+    std::atomic<int> total_pages_in{0};
+    std::atomic<int> total_pages_out{0};
+    std::atomic<int> clean_evictions{0};
+    std::atomic<int> dirty_evictions{0};
+    std::atomic<long long> page_table_accesses{0}; // Without a core; the rest are per-core
+    std::atomic<long long> eviction_ns{0};
+    std::atomic<long long> frames_scanned{0};
+    std::atomic<int> pages_prefetched{0};
+    std::atomic<int> prefetch_hits{0};
+    std::atomic<int> prefetch_wasted{0};
+    std::atomic<int> background_reclaims{0};
+    std::atomic<int> direct_reclaims{0};
+    std::atomic<int> swap_zero_pages{0};
+    std::atomic<int> swap_cache_pages{0};
+    std::atomic<long long> swap_cache_bytes{0};
+};
+
+// Swap device: a binary file of fixed-size slots, one page per slot, with
+// a bitmap of used slots. Pages are read and written one slot at a time.
+class SwapDevice {
+public:
+    ~SwapDevice() { close(); }
+
+    bool open(const std::string& path, int page_words);
+    void close();
+
+    int allocSlot(); // Grows the device when every slot is in use
+    void freeSlot(int slot);
+    bool writeSlot(int slot, const uint16_t* data);
+    bool readSlot(int slot, uint16_t* data);
+
+    int totalSlots() const { return total_slots; }
+    int usedSlots() const { return used_slots; }
+
+private:
+    int fd = -1;
+    size_t page_bytes = 0;
+    std::vector<uint64_t> bitmap;
+    std::atomic<int> total_slots{0};
+    std::atomic<int> used_slots{0};
+    size_t search_hint = 0; // First bitmap word that may have a free bit
 };
 
 class MemoryManager {
 public:
     static MemoryManager& getInstance();
 
-    void initialize(int max_overall_mem, int mem_per_frame);
+    void initialize(int max_overall_mem, int mem_per_frame, int num_cores = 1,
+        const std::string& replacement = "clock");
+    // Fault-around: pages after a faulting one to load while frames are
+    // free (0 = off). Each process adapts its own window up to this.
+    void setPrefetchPages(int pages) { prefetch_pages = std::max(0, pages); }
+    // Background reclaim: once free frames drop below low, a thread evicts
+    // pages until high are free (low = 0 = off)
+    void setReclaimWatermarks(int low, int high);
+    void shutdown(); // Stops the reclaim thread
+    // Bytes of compressed pages kept in memory before spilling to disk
+    void setSwapCacheLimit(long long bytes) { swap_cache_limit = std::max(0LL, bytes); }
     bool allocateMemory(int process_id, int process_memory_size);
     void deallocateMemory(int process_id);
 
-    // Memory access methods
-    bool readMemory(int process_id, int virtual_address, uint16_t& value);
-    bool writeMemory(int process_id, int virtual_address, uint16_t value);
+    // Memory access methods. Accesses made on a core (>= 0) go through
+    // that core's TLB first.
+    bool readMemory(int process_id, int virtual_address, uint16_t& value, int core = -1);
+    bool writeMemory(int process_id, int virtual_address, uint16_t value, int core = -1);
 
     // Page fault handling
     bool handlePageFault(int process_id, int page_number);
+    bool pageIn(int process_id, int virtual_address) {
+        return initialized && handlePageFault(process_id, virtual_address / mem_per_frame);
+    }
+    // True unless touching the address would fault (bad addresses count as
+    // resident; the access itself reports them)
+    bool isResident(int process_id, int virtual_address, int core = -1);
 
     // Statistics
     MemoryStats getStats();
     void printMemorySnapshot();
 
+    // Writes every swapped-out page to a human-readable text file
+    int dumpBackingStore(const std::string& filename);
+
     // Helper methods
     int getFrameForProcess(int process_id, int page_number);
     bool isInitialized() const { return initialized; }
+    int getTotalFrames() const { return total_frames; }
+    int pagesFor(int memory_size) const { return mem_per_frame > 0 ? (memory_size + mem_per_frame - 1) / mem_per_frame : 0; }
+    long long getCommittedPages() const { return committed_pages; } // Pages of every allocated process
+    int getPageFaults(int process_id);
+
+    // Contention benchmark: 'threads' synthetic processes, one per core,
+    // hammer their own resident pages in a private pool. Returns accesses
+    // per second.
+    double runContentionBenchmark(int threads, int accesses_per_thread);
 
 private:
     MemoryManager() = default;
+    ~MemoryManager();
     MemoryManager(const MemoryManager&) = delete;
     MemoryManager& operator=(const MemoryManager&) = delete;
 
+    // Physical RAM: one contiguous, page-aligned arena for all frames
+    void allocateArena(size_t bytes);
+    void releaseArena();
+    uint16_t* frameData(int frame_id) { return arena + (size_t)frame_id * mem_per_frame; }
+
+    void resetPool(int max_mem, int frame_size, int num_cores, const std::string& replacement_name);
+
+    // Page table lookup; the caller holds page_tables_mutex
+    ProcessMemory* findProcess(int process_id);
+    // Same through the core's cache; takes the locks itself
+    std::shared_ptr<ProcessMemory> lookupProcess(int process_id, int core);
+    bool access(int process_id, int virtual_address, uint16_t& value, bool is_write, int core);
+
+    // Caller holds the process's mutex
+    bool faultIn(ProcessMemory& pm, int page_number);
+    void prefetchAround(ProcessMemory& pm, int page_number);
+    void assignFrame(ProcessMemory& pm, int page_number, int frame_id); // Also needs pool_mutex
+
+    // Frame pool; the caller holds pool_mutex
     int findFreeFrame();
-    int evictPage(); // LRU page replacement
-    uint64_t getCurrentTime();
+    void releaseFrame(int frame_id);
+    // Frees one frame chosen by the replacement policy; false if every
+    // candidate was busy. faulting is the caller's locked process, if any.
+    bool evictPage(ProcessMemory* faulting, std::unique_lock<std::mutex>& pool_lock);
+    void reclaimWorker();
 
-    // Backing Store Helpers
-    void saveFrameToBackingStore(int frame_id, int process_id, int page_num);
-    bool loadFrameFromBackingStore(int frame_id, int process_id, int page_num);
+    // Reports an access to policies that track every one (exact LRU)
+    void notifyAccess(int frame_id);
 
-    bool initialized = false;
+    // TLB helpers
+    static int tlbIndex(int process_id, int page_number) {
+        return (unsigned)(process_id * 31 + page_number) % CoreTlb::kEntries;
+    }
+    void tlbFill(int core, int process_id, int page_number, int frame_id, bool writable);
+    void tlbShootdown(int process_id, int page_number);
+    void tlbFlushProcess(int process_id);
+
+    // Backing Store Helpers (take swap_mutex). load returns where the
+    // page came from, SWAP_NONE for a fresh zero page.
+    void saveFrameToBackingStore(int frame_id, int process_id, int page_num, PageTableEntry& pte);
+    SwapTier loadFrameFromBackingStore(int frame_id, const PageTableEntry& pte);
+    void releaseSwapData(SwapEntry& entry); // Caller holds swap_mutex
+    void freeSwapEntry(int entry_id);       // Caller holds swap_mutex
+
+    std::atomic<bool> initialized{false};
     int max_overall_mem = 0;
     int mem_per_frame = 0;
     int total_frames = 0;
+    int prefetch_pages = 0;
 
     std::vector<Frame> frames;
-    std::unordered_map<int, std::vector<PageTableEntry>> page_tables; // process_id -> page table
-    std::unordered_map<int, int> process_memory_sizes; // process_id -> total memory size
+    uint16_t* arena = nullptr;
+    size_t arena_bytes = 0;
+    std::vector<int> free_frame_list; // Stack of free frame ids
+    std::unique_ptr<ReplacementPolicy> replacement;
+    bool track_accesses = false; // replacement->tracksAccesses()
+    // Reference bit of each frame, set on every hit
+    std::unique_ptr<std::atomic<bool>[]> frame_accessed;
+    std::vector<std::unique_ptr<CoreTlb>> tlbs;
+
+    // Lock order: page_tables_mutex, then a process's mutex, then
+    // pool_mutex, then swap_mutex, then a core's TLB mutex. Eviction only
+    // try_locks the victim's process, skipping it if busy.
+    std::unordered_map<int, std::shared_ptr<ProcessMemory>> page_tables; // process_id -> page table
+    std::shared_mutex page_tables_mutex;
+    std::mutex pool_mutex; // frames, free list and replacement policy
+
+    std::thread reclaim_thread;
+    std::condition_variable reclaim_cv; // Waits on pool_mutex
+    bool reclaim_running = false;
+    int free_frames_low = 0;
+    int free_frames_high = 0;
 
-    // [FIX]: Simulation of Disk Drive (Backing Store)
-    // Map Key: "PID_PageNum", Value: Vector of data
-    // We update the text file whenever this changes.
-    std::unordered_map<std::string, std::vector<uint16_t>> backing_store_disk;
+    // Backing Store: PTEs hold a handle into swap_entries. Pages go to the
+    // swap cache until it reaches swap_cache_limit, then to swap_device.
+    std::vector<SwapEntry> swap_entries;
+    std::vector<int> free_swap_entries;
+    long long swap_cache_limit = 0;
+    SwapDevice swap_device;
+    std::mutex swap_mutex;
 
-    MemoryStats stats;
-    std::mutex memory_mutex;
-    uint64_t access_counter = 0;
+    MemoryCounters counters;
+    std::atomic<long long> committed_pages{0};
 };
 
 #endif // MEMORY_MANAGER_H
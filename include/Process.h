@@ -9,12 +9,19 @@
 #include <cstdint>
 #include <random>
 #include <mutex>
+#include <memory>
+#include <atomic>
+#include <functional>
+#include <deque>
+#include "Config.h"
 
 // Instruction Types
 enum InstructionType {
     PRINT, DECLARE, ADD, SUBTRACT, SLEEP, FOR_LOOP, READ, WRITE
 };
 
+// Source-level instruction, as generated or parsed. Only used to build a
+// process; it is compiled to bytecode (Op) before the process runs.
 struct Instruction {
     InstructionType type;
     std::string msg;
@@ -31,65 +38,385 @@ struct Instruction {
     uint16_t write_value = 0;
 };
 
+// Bytecode
+enum OpCode : uint8_t {
+    OP_PRINT, OP_DECLARE, OP_ADD, OP_SUBTRACT, OP_SLEEP, OP_LOOP, OP_ENDLOOP, OP_READ, OP_WRITE
+};
+
+enum OpFlags : uint8_t {
+    OPF_IMM_A = 1 << 0, // a is an immediate value, not a register slot
+    OPF_IMM_B = 1 << 1, // b is an immediate value, not a register slot
+    OPF_VAR = 1 << 2    // PRINT: also print register dst
+};
+
+// One compiled instruction.
+//   DECLARE/ADD/SUBTRACT: dst = a (+|-) b
+//   SLEEP:   a = ticks
+//   LOOP:    dst = loop depth, a = repeat count, b = distance to the op after its ENDLOOP
+//   ENDLOOP: dst = loop depth, a = distance back to the first op of the body
+//   READ:    dst = register, a = address
+//   WRITE:   a = address, b = value
+struct Op {
+    uint8_t opcode;
+    uint8_t flags = 0;
+    uint8_t dst = 0;
+    uint8_t reserved = 0;
+    uint16_t a = 0;
+    uint16_t b = 0;
+};
+
+// Register file limits. Variables beyond kMaxVars are ignored: writes go to
+// the sink register and reads see 0.
+const int kMaxVars = 32;
+const int kSinkSlot = kMaxVars;
+const int kMaxLoopDepth = 4;
+
+// Lazily generated processes keep one chunk of this many ops at a time
+const int kCodeChunk = 256;
+
+// Process log entry. Stored in binary form; the text is only built when a
+// screen or report asks for it.
+enum LogKind : uint8_t {
+    LOG_PRINT, LOG_PRINT_VALUE, LOG_READ, LOG_WRITE, LOG_READ_ERROR, LOG_WRITE_ERROR
+};
+
+struct LogEvent {
+    int64_t timestamp = 0;  // system_clock ticks since epoch
+    uint8_t kind = LOG_PRINT;
+    uint8_t slot = 0;       // Register for LOG_PRINT_VALUE / LOG_READ
+    uint16_t address = 0;
+    uint16_t value = 0;
+};
+
+// Keeps the most recent kCapacity log events of a process. Storage is only
+// allocated on the first push.
+class LogRing {
+public:
+    static const int kCapacity = 32;
+
+    void push(uint8_t kind, uint8_t slot = 0, uint16_t address = 0, uint16_t value = 0);
+    int size() const { return (int)events.size(); }
+    uint64_t count() const { return total; } // Events ever pushed
+    const LogEvent& at(int i) const; // 0 is the oldest event kept
+
+private:
+    std::vector<LogEvent> events;
+    uint64_t total = 0;
+};
+
+// Process life cycle. Transitions are made by the Scheduler, which keeps
+// a counter per state.
+//   NEW -> READY            admitted and queued
+//   READY -> RUNNING        dispatched on a core
+//   RUNNING -> READY        time slice expired, or the scheduler stopped
+//   RUNNING -> SLEEPING     SLEEP; counts down in the run queue
+//   RUNNING -> BLOCKED      waiting on a page fault (page-fault-latency)
+//   SLEEPING/BLOCKED -> READY / RUNNING
+//   RUNNING/SLEEPING -> FINISHED
+enum ProcessState : uint8_t {
+    STATE_NEW, STATE_READY, STATE_RUNNING, STATE_SLEEPING, STATE_BLOCKED, STATE_FINISHED
+};
+const int kProcessStates = 6;
+
+// Scheduling metrics, kept by the Scheduler. Times are steady_clock ns.
+struct ProcessMetrics {
+    int64_t arrival_ns = 0;       // Submitted to the scheduler
+    int64_t ready_since_ns = 0;   // Last put in a run queue; 0 while not queued
+    int64_t wait_ns = 0;          // Total time READY in a run queue
+    int64_t response_ns = -1;     // Arrival to first dispatch
+    int cpu_ticks = 0;            // Ticks spent executing instructions
+    int sleep_ticks = 0;
+    int context_switches = 0;     // Loaded onto a core that last ran another process
+    int page_faults = 0;          // Set when the process finishes
+};
+
+// Summary of a process: a copy of a live PCB's displayed fields, or the
+// record a finished process is retired into once its PCB is freed.
+struct ProcessRecord {
+    static const int kLogTail = 20;  // Lines screen -r shows
+
+    int pid = 0;
+    std::string name;
+    ProcessState state = STATE_NEW;
+    bool finished = false;
+    int pc = 0;
+    int total_instructions = 0;
+    int executed = 0;
+    int expanded_length = 0;
+    int cpu_core = -1;
+    int sleep_ticks = 0;
+    int memory_size = 0;
+    std::chrono::system_clock::time_point start_time;
+    std::chrono::system_clock::time_point end_time;
+    std::shared_ptr<const std::vector<std::string>> symbols;
+    ProcessMetrics metrics;          // Retired records only
+    int log_count = 0;
+    LogEvent log_tail[kLogTail];     // Oldest first
+};
+
+// Fields status screens read while a process runs
+struct ProcessStatus {
+    int pc = 0;
+    int executed = 0;
+    int cpu_core = -1;
+    int sleep_ticks = 0;
+    int expanded_length = 0;
+    bool finished = false;
+    std::chrono::system_clock::time_point start_time;
+    std::chrono::system_clock::time_point end_time;
+};
+
+// Seqlock around a ProcessStatus and the tail of the process log. Writers
+// hold the process's pcb_mutex, so there is one at a time; readers never
+// block them and retry instead if a publish overlapped their copy.
+class StatusSeqlock {
+public:
+    // Copies only the log events pushed since the last publish
+    void publish(const ProcessStatus& status, const LogRing& log);
+    // Fills log_tail oldest first when given
+    ProcessStatus read(LogEvent* log_tail = nullptr, int* log_count = nullptr) const;
+
+private:
+    static const int kLogTail = ProcessRecord::kLogTail;
+
+    std::atomic<uint32_t> sequence{ 0 };  // Odd while a publish is in progress
+    std::atomic<int> pc{ 0 };
+    std::atomic<int> executed{ 0 };
+    std::atomic<int> cpu_core{ -1 };
+    std::atomic<int> sleep_ticks{ 0 };
+    std::atomic<int> expanded_length{ 0 };
+    std::atomic<bool> finished{ false };
+    std::atomic<int64_t> start_time{ 0 };
+    std::atomic<int64_t> end_time{ 0 };
+    std::atomic<uint64_t> log_total{ 0 };  // Events published; event n is in slot n % kLogTail
+    std::atomic<int64_t> log_times[kLogTail] = {};
+    std::atomic<uint64_t> log_events[kLogTail] = {}; // kind, slot, address, value packed
+};
+
+// Config a random program is generated under, captured when the process is
+// created so its chunks do not change with a later initialize
+struct WorkloadParams {
+    int mix[8] = {};             // Weights of instruction types 0..7
+    AccessPattern pattern = ACCESS_UNIFORM;
+    int page_size = 1;           // mem-per-frame, in words
+};
+
 // Process Control Block
 struct PCB {
     int pid;
     std::string name;
     int pc = 0;
-    std::unordered_map<std::string, uint16_t> vars;
-    std::vector<Instruction> instructions;
+    std::vector<Op> code;               // code[i] is the op at pc == code_base + i
+    int code_base = 0;
+    uint64_t code_seed = 0;             // Non-zero: code is regenerated per chunk from this seed
+    int sized_chunks = 0;               // Seeded chunks counted in expanded_length so far
+    WorkloadParams workload;            // What seeded chunks are generated under
+    std::shared_ptr<const std::vector<std::string>> symbols; // register slot -> variable name
+    uint16_t regs[kMaxVars + 1] = {};
+    uint16_t loop_counters[kMaxLoopDepth] = {};
     int sleep_ticks = 0;
+    int io_wait_ticks = 0;  // BLOCKED on a page fault while > 0
+    int fault_address = -1; // Address whose page is being brought in
     bool finished = false;
-    std::vector<std::string> screenBuffer;
+    LogRing log;
     std::chrono::system_clock::time_point start_time;
     std::chrono::system_clock::time_point end_time;
     int cpu_core = -1;
     int total_instructions = 0;
+    int executed = 0;         // Instructions run so far, every loop pass included
+    int expanded_length = 0;  // Instructions it runs in all: the code with its loops unrolled.
+                              // Seeded code counts unloaded chunks at their declared length.
     int memory_size = 0;  // Added for memory management
+    int sched_level = 0;  // MLFQ queue level
+    std::atomic<uint8_t> state{ STATE_NEW }; // ProcessState; written by the Scheduler
+    ProcessMetrics metrics;  // Written by whichever thread holds the process
+    uint64_t table_slot = 0; // ProcessManager table slot
     std::mutex pcb_mutex;
+    StatusSeqlock status;    // Published copy of the fields above, for status screens
+
+    // Publishes pc, executed, cpu_core, sleep_ticks, expanded_length, finished,
+    // times and new log events; hold pcb_mutex
+    void publishStatus();
+    // Marks the process finished and releases its code; hold pcb_mutex
+    void finish();
+};
+
+// Bytecode Compiler
+// Resolves variable names to register slots and flattens FOR_LOOP bodies
+// into LOOP/ENDLOOP jumps.
+class BytecodeCompiler {
+public:
+    static void compile(const std::vector<Instruction>& program, PCB& p);
+
+private:
+    explicit BytecodeCompiler(PCB& p) : p(p) {}
+
+    void emit(const Instruction& inst, int depth);
+    uint8_t destination(const std::string& name);
+    static uint16_t address(int memory_address);
+    void source(bool isVar, const std::string& name, uint16_t value, uint8_t imm_flag,
+        uint8_t& flags, uint16_t& operand);
+
+    PCB& p;
+    std::vector<std::string> symbols;
+    std::unordered_map<std::string, uint8_t> slots;
 };
 
 // Process Generator
+// Everything a random chunk's generation depends on besides its seed
+struct WorkloadState {
+    uint64_t rng;
+    uint64_t seed;               // Process seed, for per-phase choices
+    int memory_size;
+    int page_size;               // From the process's WorkloadParams
+    int op_base;                 // Process-wide index of out[out_start]
+    size_t out_start;
+    const int* mix;
+    AccessPattern pattern;
+    std::vector<double> zipf_cdf; // ACCESS_ZIPF: cumulative weight of page ranks
+};
+
 class ProcessGenerator {
 public:
     ProcessGenerator();
-    Instruction makeRandomInstruction(int depth = 0, int memory_size = 0);
     PCB* createRandomProcess(int pid, int memory_size = 0);
     PCB* createNamedProcess(const std::string& name, int pid, int memory_size = 0);
     PCB* createCustomProcess(const std::string& name, int pid, int memory_size, const std::string& instructions_str);
     
+    // Fills p.code with the chunk containing p.pc (lazy processes only)
+    static void loadCodeChunk(PCB& p);
+
 private:
     std::mt19937 rng;
     Instruction parseInstruction(const std::string& inst_str);
+
+    // Random programs are a pure function of (seed, chunk index), so a lazy
+    // process can rebuild any chunk and an eager one is all chunks in a row.
+    static void emitChunk(uint64_t seed, const WorkloadParams& params, int chunk, int length,
+        int memory_size, std::vector<Op>& out);
+    static int makeRandomInstruction(WorkloadState& w, int depth, int budget, std::vector<Op>& out);
+    static uint16_t makeAddress(WorkloadState& w, int op_index);
+    static uint32_t nextRandom(uint64_t& state);
 };
 
 // Instruction Executor
 class InstructionExecutor {
 public:
-    static void execute(PCB& process, Instruction& instruction);
+    // Executes the op at process.pc
+    static void execute(PCB& process);
+
+    // Data address the op at process.pc will access (READ/WRITE), or -1
+    static int memoryOperand(PCB& process);
+
+    // Instructions code runs: a LOOP's body and ENDLOOP count once per pass
+    static int expandedLength(const std::vector<Op>& code);
+
+    static std::string formatLog(const LogEvent& event, const std::string& process_name,
+        const std::vector<std::string>* symbols);
+};
+
+// Process table. Every registered process takes the next slot of an
+// append-only table of fixed-size chunks. The slot holds the PCB while the
+// process is live and its ProcessRecord once it is retired.
+enum SlotState : uint8_t { SLOT_LIVE, SLOT_RETIRED, SLOT_DROPPED };
+
+struct ProcessSlot {
+    std::atomic<PCB*> pcb{ nullptr };          // Null once retired
+    std::atomic<uint8_t> state{ SLOT_LIVE };
+    ProcessRecord record;                      // Immutable once SLOT_RETIRED
+};
+
+const int kProcessChunk = 256;
+
+struct ProcessChunk {
+    ProcessSlot slots[kProcessChunk];
+    std::atomic<uint64_t> live[kProcessChunk / 64] = {}; // Bit per SLOT_LIVE slot, for live-only walks
+    int dropped = 0;  // Writer only; the chunk is freed when all are dropped
+};
+
+// Chunk pointers for chunk numbers [first_chunk, first_chunk + capacity).
+// Replaced (not resized) when it fills up, so readers never see it move.
+struct ProcessDirectory {
+    uint64_t first_chunk = 0;
+    size_t capacity = 0;
+    std::unique_ptr<std::atomic<ProcessChunk*>[]> chunks;
 };
 
 // Process Manager
+// Writers (addProcess, retireProcess) serialize on process_map_mutex.
+// Readers walk the table inside an epoch instead: anything a writer unlinks
+// (a retired PCB, a dropped chunk, an old directory) is freed only after
+// every reader that could have seen it has left.
 class ProcessManager {
 public:
     static ProcessManager& getInstance();
     
     void addProcess(PCB* process);
-    PCB* getProcess(const std::string& name);
-    PCB* getProcess(int pid);
     bool processExists(const std::string& name);
-    std::unordered_map<std::string, PCB*> getAllProcesses();
+
+    // Moves a finished process into its slot's record. The PCB is freed once
+    // no reader can still see it; the caller must not use it afterwards.
+    void retireProcess(PCB* process);
+
+    // Live processes are summarized from their published status and log
+    // tail, without taking pcb_mutex
+    bool findRecord(const std::string& name, ProcessRecord& record);
+    bool findRecord(int pid, ProcessRecord& record);
+
+    // Visits processes in registration order until visit returns false.
+    // Does not copy the table and never blocks addProcess or retireProcess.
+    // live_only skips retired slots by their chunk's live bits, so it costs
+    // the live processes plus one check per chunk.
+    void forEachRecord(const std::function<bool(const ProcessRecord&)>& visit, bool live_only = false);
+
+    int getLiveCount() const { return live_count; }
+    unsigned long long getRetiredCount() const { return retired_count; }
+    unsigned long long getRecordCount() const { return retired_count - dropped_count; } // Retired and still listed
+
     void cleanup();
-    std::mutex& getProcessMapMutex() { return process_map_mutex; }
 
 private:
     ProcessManager() = default;
     ProcessManager(const ProcessManager&) = delete;
     ProcessManager& operator=(const ProcessManager&) = delete;
+
+    static void summarize(const PCB& process, ProcessRecord& record, bool with_log);
+
+    // Epochs
+    class ReadGuard {
+    public:
+        explicit ReadGuard(ProcessManager& pm);
+        ~ReadGuard();
+    private:
+        ProcessManager& pm;
+        uint64_t epoch;
+    };
+    void deferFree(std::function<void()> release);
+    void reclaim();
+
+    // Table (slot lookups must hold process_map_mutex or a ReadGuard)
+    ProcessSlot* findSlot(uint64_t slot) const;
+    ProcessSlot& appendSlot();
+    bool readSlot(uint64_t slot, ProcessRecord& record);
+    void dropSlot(uint64_t slot);
+    void setLiveBit(uint64_t slot, bool live);
     
-    std::unordered_map<std::string, PCB*> all_processes;
-    std::unordered_map<int, PCB*> pid_to_process;
+    std::unordered_map<std::string, uint64_t> name_index;
+    std::unordered_map<int, uint64_t> pid_index;
     std::mutex process_map_mutex;
+
+    std::atomic<ProcessDirectory*> directory{ nullptr };
+    std::atomic<uint64_t> published{ 0 };  // Slots [0, published) are readable
+    std::atomic<int> live_count{ 0 };
+    std::atomic<unsigned long long> retired_count{ 0 };
+    std::atomic<unsigned long long> dropped_count{ 0 };
+
+    // With process-history N, only the last N retired slots are kept
+    std::deque<uint64_t> history;
+
+    std::atomic<uint64_t> epoch{ 0 };
+    std::atomic<int> readers[2] = {};
+    std::vector<std::pair<uint64_t, std::function<void()>>> garbage;
 };
 
 #endif // PROCESS_H
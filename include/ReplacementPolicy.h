@@ -0,0 +1,111 @@
+#ifndef REPLACEMENT_POLICY_H
+#define REPLACEMENT_POLICY_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Chooses which resident frame to evict. Selected by the "page-replacement"
+// key in config.txt. Every call is made under MemoryManager's pool_mutex.
+class ReplacementPolicy {
+public:
+    virtual ~ReplacementPolicy() = default;
+
+    virtual const char* name() const = 0;
+    virtual void reset(int total_frames) = 0;
+    virtual void pageLoaded(int frame_id) = 0;
+    virtual void frameReleased(int frame_id) = 0;
+
+    // True if every access must be reported through pageAccessed. Other
+    // policies only look at the per-frame accessed bits.
+    virtual bool tracksAccesses() const { return false; }
+    virtual void pageAccessed(int) {}
+
+    // Picks a victim. 'accessed' holds the per-frame reference bits, set on
+    // every hit; policies read and clear them as they need. claim(frame)
+    // locks the frame's owner and returns false if it is busy. Returns the
+    // claimed frame or -1, adding the frames examined to 'scanned'.
+    virtual int selectVictim(std::atomic<bool>* accessed, const std::function<bool(int)>& claim, long long& scanned) = 0;
+};
+
+// Resident frames in an intrusive doubly linked list, oldest at the head
+class FrameList {
+public:
+    void reset(int total_frames);
+    void pushBack(int frame_id);
+    void unlink(int frame_id);
+    void moveToBack(int frame_id);
+    int head() const { return list_head; }
+    int next(int frame_id) const { return links[frame_id].next; }
+
+private:
+    struct Link {
+        int prev = -1;
+        int next = -1;
+        bool linked = false;
+    };
+    std::vector<Link> links;
+    int list_head = -1;
+    int list_tail = -1;
+};
+
+// Evicts in load order, ignoring accesses
+class FIFOReplacement : public ReplacementPolicy {
+public:
+    const char* name() const override { return "fifo"; }
+    void reset(int total_frames) override { list.reset(total_frames); }
+    void pageLoaded(int frame_id) override { list.pushBack(frame_id); }
+    void frameReleased(int frame_id) override { list.unlink(frame_id); }
+    int selectVictim(std::atomic<bool>* accessed, const std::function<bool(int)>& claim, long long& scanned) override;
+
+protected:
+    FrameList list;
+};
+
+// Exact LRU: every access moves its frame to the back of the list, which
+// costs a pool_mutex round trip per access (TLB hits included)
+class LRUReplacement : public FIFOReplacement {
+public:
+    const char* name() const override { return "lru"; }
+    bool tracksAccesses() const override { return true; }
+    void pageAccessed(int frame_id) override { list.moveToBack(frame_id); }
+};
+
+// Second chance: a hand sweeps the frames, clearing accessed bits, and
+// takes the first frame found unreferenced
+class ClockReplacement : public ReplacementPolicy {
+public:
+    const char* name() const override { return "clock"; }
+    void reset(int total_frames) override;
+    void pageLoaded(int frame_id) override { resident[frame_id] = true; }
+    void frameReleased(int frame_id) override { resident[frame_id] = false; }
+    int selectVictim(std::atomic<bool>* accessed, const std::function<bool(int)>& claim, long long& scanned) override;
+
+protected:
+    std::vector<char> resident;
+    int hand = 0;
+};
+
+// WSClock: the clock sweep, but a frame is only evicted once it has gone
+// unreferenced for more than 'window' page loads (outside the working
+// set). If every frame is in a working set, the stalest one goes.
+class WSClockReplacement : public ClockReplacement {
+public:
+    const char* name() const override { return "wsclock"; }
+    void reset(int total_frames) override;
+    void pageLoaded(int frame_id) override;
+    int selectVictim(std::atomic<bool>* accessed, const std::function<bool(int)>& claim, long long& scanned) override;
+
+private:
+    std::vector<uint64_t> last_use;
+    uint64_t now = 0; // Virtual time: page loads so far
+    uint64_t window = 0;
+};
+
+// Returns nullptr for an unknown policy name
+std::unique_ptr<ReplacementPolicy> makeReplacementPolicy(const std::string& name);
+
+#endif // REPLACEMENT_POLICY_H
@@ -2,12 +2,26 @@
 #define SCHEDULER_H
 
 #include "Process.h"
+#include "SchedulingPolicy.h"
 #include <vector>
-#include <queue>
+#include <memory>
 #include <thread>
 #include <mutex>
 #include <atomic>
 #include <string>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+
+// Per-core run queue. A core pops from its own queue and only touches
+// another core's queue when it has nothing left to run (work stealing).
+// The policy decides the order within the queue.
+struct RunQueue {
+    std::unique_ptr<SchedulingPolicy> policy;
+    std::mutex mutex;
+    std::atomic<int> size{ 0 }; // Lock-free hint for thieves
+    std::vector<PCB*> io_wait; // Processes blocked on a page fault; only the core's worker touches it
+};
 
 // CPU Scheduler
 class Scheduler {
@@ -18,13 +32,18 @@ public:
     bool stop();
     bool isRunning() const { return scheduler_running; }
     void enqueueProcess(PCB* process);
-    int getCoresUsed();
+    int getCoresUsed() const { return cores_busy; }
+    std::string getPolicyName();
     std::vector<bool> getCPUBusy();
-    std::mutex& getReadyQueueMutex() { return ready_queue_mutex; }
+    int getStateCount(ProcessState state) const { return state_counts[state]; }
+    int getUnfinishedCount() const;
 
     unsigned long long getActiveTicks() const { return active_ticks; }
-    unsigned long long getIdleTicks() const { return idle_ticks; }
-    unsigned long long getTotalTicks() const { return active_ticks + idle_ticks; }
+    unsigned long long getIdleTicks() const;
+    unsigned long long getIowaitTicks() const { return iowait_ticks; }
+    unsigned long long getTotalTicks() const { return active_ticks + getIdleTicks() + iowait_ticks; }
+    unsigned long long getBlockingFaults() const { return blocking_faults; }
+    int getPendingAdmissions();
 
 private:
     Scheduler() = default;
@@ -33,27 +52,76 @@ private:
     
     void cpuWorker(int id);
     void processGeneratorWorker();
+
+    // Run queue helpers
+    void buildRunQueues(int num_queues, const std::string& policy_name);
+    PCB* dequeueProcess(int id);
+    PCB* stealProcess(int thief);
+    void pushRunQueue(int id, PCB* process, bool requeue = false);
+    void placeProcess(PCB* process);
+
+    // Process and core state
+    void setState(PCB* process, ProcessState state);
+    void setCoreProcess(int id, int pid);
+
+    // Idle core parking
+    void waitForWork(int id);
+    bool hasQueuedWork() const;
+    void wakeIdleCore();
+    long long getTickNanos() const;
+    void recordTickDuration(std::chrono::steady_clock::time_point since, int ticks);
+
+    // Admission control (memory-overcommit > 0)
+    void admitOrDefer(PCB* process);
+    void admitPending();
+    bool fitsCommitLimit(int memory_size) const;
+    long long reservePages(PCB* process);
+    bool admit(PCB* process, long long reserved_pages);
+
+    // Asynchronous page faults (page-fault-latency > 0)
+    int findMissingPage(PCB* process, int core);
+    void tickIoWait(int id, long long ticks);
     
     std::atomic<bool> scheduler_running{false};
     std::vector<std::thread> cpu_threads;
     std::thread process_generator_thread;
     
-    std::queue<PCB*> ready_queue;
-    std::mutex ready_queue_mutex;
+    std::vector<std::unique_ptr<RunQueue>> run_queues;
+    int run_queue_quantum = 0;  // quantum-cycles the run queue policies were built with
+    std::atomic<unsigned> next_run_queue{ 0 };
+
+    std::mutex idle_mutex;
+    std::condition_variable idle_cv;
+    std::atomic<int> parked_cores{ 0 };
+    std::atomic<long long> tick_ns{ 1000 }; // Measured tick length when delay-per-exec is 0
     
-    std::vector<bool> cpu_busy;
+    std::unique_ptr<std::atomic<int>[]> core_process; // pid on each core, -1 while idle
+    std::unique_ptr<std::atomic<long long>[]> core_parked_since; // steady_clock ns, 0 while the core is not parked
+    int num_cores = 0;
+    std::atomic<int> cores_busy{ 0 };
+    std::atomic<int> state_counts[kProcessStates] = {};
     std::vector<int> cpu_process_count;
     std::mutex cpu_stats_mutex;
     
+    // Generated processes waiting for committed memory to drop, in order
+    std::deque<PCB*> pending_admission;
+    std::mutex admission_mutex;
+    std::atomic<long long> admitting_pages{ 0 }; // Reserved, not yet allocated
+
     ProcessGenerator process_generator;
     int next_pid = 1;
     std::atomic<unsigned long long> active_ticks{ 0 };
     std::atomic<unsigned long long> idle_ticks{ 0 };
+    std::atomic<unsigned long long> iowait_ticks{ 0 }; // Idle, but a fault is in flight
+    std::atomic<unsigned long long> blocking_faults{ 0 };
 };
 
 // Screen Mode
 enum ScreenMode { MAIN_MENU, PROCESS_SCREEN };
 
+// screen -ls filters
+enum ListFilter { LIST_ALL, LIST_RUNNING, LIST_FINISHED };
+
 // Screen Manager
 class ScreenManager {
 public:
@@ -61,7 +129,7 @@ public:
     
     void displayProcessScreen(const std::string& process_name);
     void processSMI();
-    void screenLS();
+    void screenLS(ListFilter filter = LIST_ALL, int limit = 0);
     void reportUtil();
     
     void setCurrentScreen(ScreenMode mode) { current_screen = mode; }
@@ -0,0 +1,115 @@
+#ifndef SCHEDULING_POLICY_H
+#define SCHEDULING_POLICY_H
+
+#include "Process.h"
+#include <deque>
+#include <list>
+#include <queue>
+#include <vector>
+#include <memory>
+#include <string>
+
+// Ready-queue ordering for one core. Selected by the "scheduler" key in
+// config.txt. Implementations are not thread-safe; the owning RunQueue
+// mutex protects every call except timeSlice.
+class SchedulingPolicy {
+public:
+    virtual ~SchedulingPolicy() = default;
+
+    virtual const char* name() const = 0;
+    virtual void push(PCB* process) = 0;
+    virtual PCB* pop() = 0;   // nullptr if empty
+    virtual size_t size() const = 0;
+
+    // Instructions the process may run before sliceExpired is consulted.
+    // Called without the queue lock.
+    virtual int timeSlice(const PCB* process) const = 0;
+
+    // The running process used up its slice. Return true to preempt it,
+    // false to grant it another slice.
+    virtual bool sliceExpired(PCB* process) = 0;
+};
+
+// First come, first served: runs each process until it sleeps or finishes
+class FCFSPolicy : public SchedulingPolicy {
+public:
+    const char* name() const override { return "fcfs"; }
+    void push(PCB* process) override { queue.push_back(process); }
+    PCB* pop() override;
+    size_t size() const override { return queue.size(); }
+    int timeSlice(const PCB*) const override;
+    bool sliceExpired(PCB*) override { return false; }
+
+private:
+    std::deque<PCB*> queue;
+};
+
+// Round robin with a fixed quantum of quantum-cycles
+class RoundRobinPolicy : public SchedulingPolicy {
+public:
+    explicit RoundRobinPolicy(int quantum) : quantum(quantum) {}
+    const char* name() const override { return "rr"; }
+    void push(PCB* process) override { queue.push_back(process); }
+    PCB* pop() override;
+    size_t size() const override { return queue.size(); }
+    int timeSlice(const PCB*) const override { return quantum; }
+    bool sliceExpired(PCB*) override { return true; }
+
+private:
+    int quantum;
+    std::deque<PCB*> queue;
+};
+
+// Shortest remaining job (expanded_length - executed). The running process is
+// checked every quantum-cycles and preempted only if a shorter job waits.
+class ShortestRemainingPolicy : public SchedulingPolicy {
+public:
+    explicit ShortestRemainingPolicy(int quantum) : quantum(quantum) {}
+    const char* name() const override { return "sjf"; }
+    void push(PCB* process) override;
+    PCB* pop() override;
+    size_t size() const override { return heap.size(); }
+    int timeSlice(const PCB*) const override { return quantum; }
+    bool sliceExpired(PCB* process) override;
+
+private:
+    struct Entry {
+        int remaining;
+        int pid;
+        PCB* process;
+        bool operator>(const Entry& other) const {
+            return remaining != other.remaining ? remaining > other.remaining : pid > other.pid;
+        }
+    };
+
+    int quantum;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap;
+};
+
+// Multilevel feedback queue. A process that uses its whole slice drops one
+// level (slices double per level); one that sleeps keeps its level. Every
+// kBoostInterval dispatches all levels are merged back into the top one.
+class MLFQPolicy : public SchedulingPolicy {
+public:
+    static const int kLevels = 3;
+    static const int kBoostInterval = 64;
+
+    explicit MLFQPolicy(int quantum) : quantum(quantum) {}
+    const char* name() const override { return "mlfq"; }
+    void push(PCB* process) override;
+    PCB* pop() override;
+    size_t size() const override { return count; }
+    int timeSlice(const PCB* process) const override;
+    bool sliceExpired(PCB* process) override;
+
+private:
+    int quantum;
+    std::list<PCB*> levels[kLevels];
+    size_t count = 0;
+    int dispatches = 0;
+};
+
+// Returns nullptr for an unknown policy name
+std::unique_ptr<SchedulingPolicy> makeSchedulingPolicy(const std::string& name, int quantum);
+
+#endif // SCHEDULING_POLICY_H
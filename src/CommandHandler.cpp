@@ -9,6 +9,7 @@
 #include <sstream>
 #include <cmath>
 #include <iomanip>
+#include <algorithm>
 
 CommandHandler& CommandHandler::getInstance() {
     static CommandHandler instance;
@@ -69,7 +70,10 @@ void CommandHandler::processCommand(const std::string& command_line, int& next_p
             int mem_per_frame = config.getMemPerFrame();
             
             if (max_mem > 0 && mem_per_frame > 0) {
-                mm.initialize(max_mem, mem_per_frame);
+                mm.initialize(max_mem, mem_per_frame, config.getNumCPU(), config.getPageReplacement());
+                mm.setPrefetchPages(config.getPrefetchPages());
+                mm.setReclaimWatermarks(config.getFreeFramesLow(), config.getFreeFramesHigh());
+                mm.setSwapCacheLimit(config.getSwapCacheSize());
             }
             
             std::cout << "Console initialized successfully.\n";
@@ -153,9 +157,9 @@ void CommandHandler::processCommand(const std::string& command_line, int& next_p
                     std::cout << "Usage: screen -r <process_name>\n";
                 }
                 else {
-                    PCB* p = pm.getProcess(proc_name);
+                    ProcessRecord record;
 
-                    if (p != nullptr && p->finished) {
+                    if (pm.findRecord(proc_name, record) && record.finished) {
                         screen.setCurrentScreen(PROCESS_SCREEN);
                         screen.setCurrentProcessName(proc_name);
                         screen.displayProcessScreen(proc_name);
@@ -166,7 +170,19 @@ void CommandHandler::processCommand(const std::string& command_line, int& next_p
                 }
             }
             else if (subcmd == "-ls") {
-                screen.screenLS();
+                ListFilter filter = LIST_ALL;
+                int limit = 0;
+                std::string option;
+                while (iss >> option) {
+                    if (option == "--running") filter = LIST_RUNNING;
+                    else if (option == "--finished") filter = LIST_FINISHED;
+                    else if (option == "--limit" && iss >> limit && limit > 0) continue;
+                    else {
+                        std::cout << "Usage: screen -ls [--running | --finished] [--limit <n>]\n";
+                        return;
+                    }
+                }
+                screen.screenLS(filter, limit);
             }
             else if (subcmd == "-c") {
                 std::string proc_name;
@@ -258,21 +274,99 @@ void CommandHandler::processCommand(const std::string& command_line, int& next_p
              unsigned long long idle_ticks = scheduler.getIdleTicks();
              unsigned long long system_ticks = 0; 
             
+             std::ios_base::fmtflags flags = std::cout.flags();
+             std::streamsize precision = std::cout.precision();
              std::cout << "\n";
              std::cout << std::setw(12) << total_mem << " bytes total memory\n";
              std::cout << std::setw(12) << used_mem << " bytes used memory\n";
              std::cout << std::setw(12) << active_mem << " bytes active memory\n";
              std::cout << std::setw(12) << inactive_mem << " bytes inactive memory\n";
              std::cout << std::setw(12) << free_mem << " bytes free memory\n";
-             std::cout << std::setw(12) << total_mem << " bytes total swap\n";
-             std::cout << std::setw(12) << total_mem << " bytes free swap\n";
+             std::cout << std::setw(12) << mm.getCommittedPages() * config.getMemPerFrame() << " bytes committed memory\n";
+             std::cout << std::setw(12) << scheduler.getPendingAdmissions() << " processes awaiting admission\n";
+             long long total_swap = (long long)stats.swap_slots_total * config.getMemPerFrame();
+             long long free_swap = (long long)(stats.swap_slots_total - stats.swap_slots_used) * config.getMemPerFrame();
+             std::cout << std::setw(12) << total_swap << " bytes total swap\n";
+             std::cout << std::setw(12) << free_swap << " bytes free swap\n";
+             long long cached_raw = (long long)stats.swap_cache_pages * config.getMemPerFrame() * 2;
+             std::cout << std::setw(12) << stats.swap_cache_bytes << " bytes in swap cache (limit " << stats.swap_cache_limit << ")\n";
+             std::cout << std::setw(12) << stats.swap_cache_pages << " pages in swap cache\n";
+             std::cout << std::setw(12) << stats.swap_zero_pages << " zero pages in swap\n";
+             std::cout << std::setw(12) << std::fixed << std::setprecision(2)
+                 << (stats.swap_cache_bytes > 0 ? (double)cached_raw / stats.swap_cache_bytes : 0.0) << " swap cache compression ratio\n";
              std::cout << std::setw(12) << active_ticks << " non-nice user cpu ticks\n";
              std::cout << std::setw(12) << idle_ticks << " idle cpu ticks\n";
+             std::cout << std::setw(12) << scheduler.getIowaitTicks() << " IO-wait cpu ticks\n";
+             std::cout << std::setw(12) << scheduler.getBlockingFaults() << " page faults that blocked a process\n";
              std::cout << std::setw(12) << stats.total_pages_in << " pages paged in\n";
              std::cout << std::setw(12) << stats.total_pages_out << " pages paged out\n";
+             std::cout << std::setw(12) << stats.clean_evictions << " clean pages evicted\n";
+             std::cout << std::setw(12) << stats.dirty_evictions << " dirty pages evicted\n";
+             std::cout << std::setw(12) << stats.tlb_hits << " TLB hits\n";
+             std::cout << std::setw(12) << stats.tlb_misses << " TLB misses\n";
+             std::cout << std::setw(12) << stats.replacement_policy << " page replacement\n";
+             int evictions = stats.clean_evictions + stats.dirty_evictions;
+             std::cout << std::setw(12) << std::fixed << std::setprecision(4)
+                 << (stats.accesses > 0 ? (double)stats.total_page_faults / stats.accesses : 0.0) << " page fault rate\n";
+             std::cout << std::setw(12) << std::setprecision(0)
+                 << (evictions > 0 ? (double)stats.eviction_ns / evictions : 0.0) << " ns per eviction\n";
+             std::cout << std::setw(12) << std::setprecision(2)
+                 << (evictions > 0 ? (double)stats.frames_scanned / evictions : 0.0) << " frames scanned per eviction\n";
+             std::cout << std::setw(12) << stats.pages_prefetched << " pages prefetched\n";
+             std::cout << std::setw(12) << stats.prefetch_hits << " prefetch hits\n";
+             std::cout << std::setw(12) << stats.prefetch_wasted << " prefetches wasted\n";
+             std::cout << std::setw(12) << stats.background_reclaims << " pages reclaimed in background\n";
+             std::cout << std::setw(12) << stats.direct_reclaims << " pages reclaimed on fault\n";
              std::cout << std::setw(12) << Utils::getTimestamp() << " boot time\n";
              std::cout << std::setw(12) << (next_pid - 1) << " forks\n";
              std::cout << "\n";
+             std::cout.flags(flags);
+             std::cout.precision(precision);
+        }
+    }
+    else if (cmd == "backing-store-dump") {
+        if (!initialized) {
+            std::cout << "ERROR: Console not initialized.\n";
+        }
+        else if (!mm.isInitialized()) {
+            std::cout << "ERROR: Memory Manager not initialized.\n";
+        }
+        else {
+            int pages = mm.dumpBackingStore("csopesy-backing-store.txt");
+            if (pages < 0) {
+                std::cout << "Error: Could not create backing store dump.\n";
+            }
+            else {
+                std::cout << pages << " swapped pages written to csopesy-backing-store.txt\n";
+            }
+        }
+    }
+    else if (cmd == "vm-bench") {
+        if (!initialized) {
+            std::cout << "ERROR: Console not initialized.\n";
+        }
+        else if (!mm.isInitialized()) {
+            std::cout << "ERROR: Memory Manager not initialized.\n";
+        }
+        else {
+            int accesses = 200000;
+            iss >> accesses;
+            int max_threads = std::max(1, config.getNumCPU());
+
+            std::ios_base::fmtflags flags = std::cout.flags();
+            std::streamsize precision = std::cout.precision();
+            std::cout << "\nMemory access contention (" << accesses << " accesses per thread)\n";
+            std::cout << std::setw(8) << "Threads" << std::setw(16) << "Accesses/s" << std::setw(10) << "Speedup" << "\n";
+            double base = 0;
+            for (int threads = 1; threads <= max_threads; threads = (threads == max_threads) ? threads + 1 : std::min(threads * 2, max_threads)) {
+                double rate = mm.runContentionBenchmark(threads, accesses);
+                if (threads == 1) base = rate;
+                std::cout << std::setw(8) << threads << std::setw(16) << std::fixed << std::setprecision(0) << rate
+                    << std::setw(9) << std::setprecision(2) << (base > 0 ? rate / base : 0) << "x\n";
+            }
+            std::cout << "\n";
+            std::cout.flags(flags);
+            std::cout.precision(precision);
         }
     }
     else if (cmd == "process-smi") {
@@ -7,6 +7,7 @@
 #include <iomanip>
 #include <chrono>
 #include <ctime>
+#include <algorithm>
 
 // Config Implementation
 Config& Config::getInstance() {
@@ -45,6 +46,39 @@ bool Config::loadFromFile(const std::string& filename) {
             mim_mem_per_proc = std::stoi(value);
         else if (key == "max-mem-per-proc")
             max_mem_per_prc = std::stoi(value);
+        else if (key == "lazy-instructions")
+            lazy_instructions = std::stoi(value) != 0;
+        else if (key == "page-replacement")
+            page_replacement = value.substr(1, value.size() - 2);
+        else if (key == "prefetch-pages")
+            prefetch_pages = std::stoi(value);
+        else if (key == "free-frames-low")
+            free_frames_low = std::stoi(value);
+        else if (key == "free-frames-high")
+            free_frames_high = std::stoi(value);
+        else if (key == "swap-cache-size")
+            swap_cache_size = std::stoll(value);
+        else if (key == "page-fault-latency")
+            page_fault_latency = std::stoi(value);
+        else if (key == "memory-overcommit")
+            memory_overcommit = std::stod(value);
+        else if (key == "instruction-mix") {
+            std::stringstream weights(value.substr(1, value.size() - 2));
+            std::string weight;
+            for (int i = 0; i < 8 && std::getline(weights, weight, ','); i++) {
+                instruction_mix[i] = std::max(0, std::stoi(weight));
+            }
+        }
+        else if (key == "access-pattern") {
+            std::string pattern = value.substr(1, value.size() - 2);
+            if (pattern == "uniform") access_pattern = ACCESS_UNIFORM;
+            else if (pattern == "sequential") access_pattern = ACCESS_SEQUENTIAL;
+            else if (pattern == "zipf") access_pattern = ACCESS_ZIPF;
+            else if (pattern == "phased") access_pattern = ACCESS_PHASED;
+            else std::cout << "ERROR: Unknown access-pattern \"" << pattern << "\", using uniform.\n";
+        }
+        else if (key == "process-history")
+            process_history = std::max(0, std::stoi(value));
 
     }
 
@@ -58,8 +92,11 @@ namespace Utils {
     }
 
     std::string getTimestamp() {
-        auto now = std::chrono::system_clock::now();
-        auto time = std::chrono::system_clock::to_time_t(now);
+        return formatTimestamp(std::chrono::system_clock::now());
+    }
+
+    std::string formatTimestamp(std::chrono::system_clock::time_point time_point) {
+        auto time = std::chrono::system_clock::to_time_t(time_point);
 
         std::tm timeinfo;
 #ifdef _WIN32
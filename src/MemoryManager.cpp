@@ -6,333 +6,860 @@
 #include <iomanip>
 #include <fstream>
 #include <sstream>
+#include <cstring>
+#include <chrono>
+#include <thread>
+#include <fcntl.h>
+#ifdef _WIN32
+#define NOMINMAX
+#include <io.h>
+#include <sys/stat.h>
+#include <windows.h>
+#else
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+// ============ SwapDevice Implementation ============
+bool SwapDevice::open(const std::string& path, int page_words) {
+    close();
+#ifdef _WIN32
+    fd = _open(path.c_str(), _O_RDWR | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+#endif
+    page_bytes = (size_t)page_words * sizeof(uint16_t);
+    bitmap.clear();
+    total_slots = used_slots = 0;
+    search_hint = 0;
+    return fd != -1;
+}
+
+void SwapDevice::close() {
+    if (fd != -1) {
+#ifdef _WIN32
+        _close(fd);
+#else
+        ::close(fd);
+#endif
+        fd = -1;
+    }
+}
+
+int SwapDevice::allocSlot() {
+    for (size_t w = search_hint; w < bitmap.size(); w++) {
+        if (bitmap[w] != UINT64_MAX) {
+            int bit = 0;
+            while (bitmap[w] & (1ULL << bit)) bit++;
+            bitmap[w] |= (1ULL << bit);
+            search_hint = w;
+            used_slots++;
+            return (int)(w * 64 + bit);
+        }
+    }
+
+    // Full: double the device (the file itself grows on the first write)
+    size_t old_words = bitmap.size();
+    bitmap.resize(std::max<size_t>(1, old_words * 2), 0);
+    total_slots = (int)bitmap.size() * 64;
+    search_hint = old_words;
+    return allocSlot();
+}
 
+void SwapDevice::freeSlot(int slot) {
+    size_t w = slot / 64;
+    if (w >= bitmap.size() || !(bitmap[w] & (1ULL << (slot % 64)))) return;
+    bitmap[w] &= ~(1ULL << (slot % 64));
+    search_hint = std::min(search_hint, w);
+    used_slots--;
+}
+
+bool SwapDevice::writeSlot(int slot, const uint16_t* data) {
+    if (fd == -1) return false;
+    long long offset = (long long)slot * page_bytes;
+#ifdef _WIN32
+    if (_lseeki64(fd, offset, SEEK_SET) < 0) return false;
+    return _write(fd, data, (unsigned)page_bytes) == (int)page_bytes;
+#else
+    return pwrite(fd, data, page_bytes, offset) == (ssize_t)page_bytes;
+#endif
+}
+
+bool SwapDevice::readSlot(int slot, uint16_t* data) {
+    if (fd == -1) return false;
+    long long offset = (long long)slot * page_bytes;
+#ifdef _WIN32
+    if (_lseeki64(fd, offset, SEEK_SET) < 0) return false;
+    return _read(fd, data, (unsigned)page_bytes) == (int)page_bytes;
+#else
+    return pread(fd, data, page_bytes, offset) == (ssize_t)page_bytes;
+#endif
+}
+
+// ============ MemoryManager Implementation ============
 MemoryManager& MemoryManager::getInstance() {
     static MemoryManager instance;
     return instance;
 }
 
-void MemoryManager::initialize(int max_mem, int frame_size) {
-    std::lock_guard<std::mutex> lock(memory_mutex);
+MemoryManager::~MemoryManager() {
+    shutdown();
+    releaseArena();
+}
+
+// Anonymous mappings are zero-filled on first touch, so even a large
+// max-overall-mem costs nothing until frames are actually used.
+void MemoryManager::allocateArena(size_t bytes) {
+    releaseArena();
+    if (bytes == 0) return;
+
+#ifdef _WIN32
+    void* mem = VirtualAlloc(nullptr, bytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    if (mem == nullptr) throw std::bad_alloc();
+#else
+    void* mem = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED) throw std::bad_alloc();
+#ifdef MADV_HUGEPAGE
+    madvise(mem, bytes, MADV_HUGEPAGE);
+#endif
+#endif
+
+    arena = static_cast<uint16_t*>(mem);
+    arena_bytes = bytes;
+}
 
+void MemoryManager::releaseArena() {
+    if (arena == nullptr) return;
+#ifdef _WIN32
+    VirtualFree(arena, 0, MEM_RELEASE);
+#else
+    munmap(arena, arena_bytes);
+#endif
+    arena = nullptr;
+    arena_bytes = 0;
+}
+
+void MemoryManager::initialize(int max_mem, int frame_size, int num_cores, const std::string& replacement_name) {
+    shutdown();
+    std::unique_lock<std::shared_mutex> tables_lock(page_tables_mutex);
+    std::lock_guard<std::mutex> pool_lock(pool_mutex);
+    std::lock_guard<std::mutex> swap_lock(swap_mutex);
+
+    resetPool(max_mem, frame_size, num_cores, replacement_name);
+
+    // Fresh swap device
+    swap_entries.clear();
+    free_swap_entries.clear();
+    counters.swap_zero_pages = 0;
+    counters.swap_cache_pages = 0;
+    counters.swap_cache_bytes = 0;
+    if (!swap_device.open("csopesy-backing-store.bin", mem_per_frame)) {
+        std::cerr << "ERROR: csopesy-backing-store.bin could not be opened.\n";
+    }
+
+    initialized = true;
+
+    std::cout << "Memory Manager initialized: " << total_frames << " frames, "
+        << mem_per_frame << " bytes per frame.\n";
+}
+
+// Frames, TLBs and page tables; the caller holds every pool lock
+void MemoryManager::resetPool(int max_mem, int frame_size, int num_cores, const std::string& replacement_name) {
     max_overall_mem = max_mem;
     mem_per_frame = frame_size;
     total_frames = max_overall_mem / mem_per_frame;
 
+    page_tables.clear();
+    committed_pages = 0;
     frames.clear();
     frames.resize(total_frames);
+    allocateArena((size_t)total_frames * mem_per_frame * sizeof(uint16_t));
+    free_frame_list.clear();
+    frame_accessed.reset(new std::atomic<bool>[total_frames]());
+
+    tlbs.clear();
+    for (int i = 0; i < std::max(1, num_cores); i++) {
+        tlbs.push_back(std::make_unique<CoreTlb>());
+    }
 
     for (int i = 0; i < total_frames; i++) {
         frames[i].frame_id = i;
         frames[i].is_free = true;
         frames[i].process_id = -1;
         frames[i].page_number = -1;
-        // Initialize physical memory for this frame with 0s
-        frames[i].data.assign(mem_per_frame, 0);
     }
 
-    // Clear backing store file
-    std::ofstream ofs("csopesy-backing-store.txt", std::ofstream::out | std::ofstream::trunc);
-    ofs.close();
-    backing_store_disk.clear();
-
-    stats.total_frames = total_frames;
-    stats.used_frames = 0;
-    stats.free_frames = total_frames;
-    stats.total_page_faults = 0;
+    replacement = makeReplacementPolicy(replacement_name);
+    if (!replacement) {
+        std::cout << "ERROR: Unknown page replacement \"" << replacement_name << "\", using clock.\n";
+        replacement = makeReplacementPolicy("clock");
+    }
+    replacement->reset(total_frames);
+    track_accesses = replacement->tracksAccesses();
 
-    initialized = true;
+    // Pushed in reverse so frames are handed out lowest id first
+    for (int i = total_frames - 1; i >= 0; i--) {
+        free_frame_list.push_back(i);
+    }
 
-    std::cout << "Memory Manager initialized: " << total_frames << " frames, "
-        << mem_per_frame << " bytes per frame.\n";
+    counters.used_frames = 0;
+    counters.free_frames = total_frames;
+    counters.total_page_faults = 0;
 }
 
 bool MemoryManager::allocateMemory(int process_id, int process_memory_size) {
-    std::lock_guard<std::mutex> lock(memory_mutex);
-
     if (!initialized) return false;
 
     // Calculate pages needed
     int num_pages = process_memory_size / mem_per_frame;
     if (process_memory_size % mem_per_frame != 0) num_pages++;
 
+    std::unique_lock<std::shared_mutex> tables_lock(page_tables_mutex);
+
     // Initialize page table
-    page_tables[process_id].resize(num_pages);
-    for (int i = 0; i < num_pages; i++) {
-        page_tables[process_id][i].valid = false;
-        page_tables[process_id][i].frame_number = -1;
+    auto& pm = page_tables[process_id];
+    if (!pm) {
+        pm = std::make_shared<ProcessMemory>();
+        pm->process_id = process_id;
+        pm->prefetch_window = prefetch_pages;
     }
-
-    process_memory_sizes[process_id] = process_memory_size;
+    std::lock_guard<std::mutex> lock(pm->mutex);
+    committed_pages += num_pages - (long long)pm->pages.size();
+    pm->pages.resize(num_pages);
+    pm->memory_size = process_memory_size;
     return true;
 }
 
 void MemoryManager::deallocateMemory(int process_id) {
-    std::lock_guard<std::mutex> lock(memory_mutex);
-
     // [DEBUG] Print to confirm deallocation is requested
     // std::cout << "DEBUG: Deallocating Memory for PID " << process_id << "\n";
 
-    // 1. Free all frames used by this process (Physical Memory)
-    for (auto& frame : frames) {
-        if (frame.process_id == process_id) {
-            frame.is_free = true;
-            frame.process_id = -1;
-            frame.page_number = -1;
-            std::fill(frame.data.begin(), frame.data.end(), 0);
-
-            // Update stats immediately
-            if (stats.used_frames > 0) stats.used_frames--;
-            if (stats.free_frames < total_frames) stats.free_frames++;
+    // 1. Unpublish the page table (Virtual Memory); new accesses now fail
+    std::shared_ptr<ProcessMemory> pm;
+    {
+        std::unique_lock<std::shared_mutex> tables_lock(page_tables_mutex);
+        auto it = page_tables.find(process_id);
+        if (it == page_tables.end()) return;
+        pm = std::move(it->second);
+        page_tables.erase(it);
+    }
+    committed_pages -= (long long)pm->pages.size();
+
+    std::lock_guard<std::mutex> lock(pm->mutex);
+    pm->released = true;
+    tlbFlushProcess(process_id);
+
+    // 2. Walk the process's own page table: free its resident frames
+    // (Physical Memory) and its swap slots (Disk / Swap). Once no frame
+    // points at pm, no evictor can reach it.
+    {
+        std::lock_guard<std::mutex> pool_lock(pool_mutex);
+        for (auto& pte : pm->pages) {
+            if (pte.valid) {
+                if (pte.prefetched) counters.prefetch_wasted++;
+                std::memset(frameData(pte.frame_number), 0, mem_per_frame * sizeof(uint16_t));
+                releaseFrame(pte.frame_number);
+            }
+        }
+    }
+    {
+        std::lock_guard<std::mutex> swap_lock(swap_mutex);
+        for (auto& pte : pm->pages) {
+            if (pte.swap_entry != -1) freeSwapEntry(pte.swap_entry);
         }
     }
+}
 
-    // 2. Remove from Page Tables (Virtual Memory)
-    if (page_tables.find(process_id) != page_tables.end()) {
-        page_tables.erase(process_id);
+void MemoryManager::setReclaimWatermarks(int low, int high) {
+    shutdown();
+    {
+        std::lock_guard<std::mutex> pool_lock(pool_mutex);
+        free_frames_low = std::max(0, std::min(low, total_frames));
+        free_frames_high = std::max(free_frames_low, std::min(high, total_frames));
+    }
+    if (free_frames_low > 0) {
+        reclaim_running = true;
+        reclaim_thread = std::thread(&MemoryManager::reclaimWorker, this);
     }
+}
 
-    // 3. Remove Memory Size tracking
-    if (process_memory_sizes.find(process_id) != process_memory_sizes.end()) {
-        process_memory_sizes.erase(process_id);
+void MemoryManager::shutdown() {
+    {
+        std::lock_guard<std::mutex> pool_lock(pool_mutex);
+        reclaim_running = false;
     }
+    reclaim_cv.notify_all();
+    if (reclaim_thread.joinable()) {
+        reclaim_thread.join();
+    }
+}
 
-    // 4. Clean backing store (Disk / Swap)
-    bool disk_updated = false;
-    for (auto it = backing_store_disk.begin(); it != backing_store_disk.end(); ) {
-        // Key format is "PID_PageNum"
-        // Check if key starts with "PID_"
-        if (it->first.find(std::to_string(process_id) + "_") == 0) {
-            it = backing_store_disk.erase(it);
-            disk_updated = true;
-        }
-        else {
-            ++it;
-        }
-    }   
-
-    if (disk_updated) {
-        std::ofstream ofs("csopesy-backing-store.txt");
-        if (ofs.is_open()) {
-            for (const auto& pair : backing_store_disk) {
-                ofs << "Key: " << pair.first << " Data: [";
-                for (size_t i = 0; i < pair.second.size(); ++i) {
-                    ofs << pair.second[i] << (i < pair.second.size() - 1 ? " " : "");
-                }
-                ofs << "]\n";
+// Sleeps until a fault leaves fewer than free_frames_low free frames, then
+// evicts (and writes back) pages until free_frames_high are free
+void MemoryManager::reclaimWorker() {
+    std::unique_lock<std::mutex> pool_lock(pool_mutex);
+
+    while (reclaim_running) {
+        reclaim_cv.wait(pool_lock, [this]() {
+            return !reclaim_running || (int)free_frame_list.size() < free_frames_low;
+        });
+
+        while (reclaim_running && (int)free_frame_list.size() < free_frames_high) {
+            if (evictPage(nullptr, pool_lock)) {
+                counters.background_reclaims++;
+            }
+            else {
+                // Every candidate is busy; retry shortly
+                reclaim_cv.wait_for(pool_lock, std::chrono::milliseconds(1));
             }
-            ofs.close();
         }
     }
 }
+
+ProcessMemory* MemoryManager::findProcess(int process_id) {
+    auto it = page_tables.find(process_id);
+    return it != page_tables.end() ? it->second.get() : nullptr;
+}
+
+// Page table of process_id through the core's cache, falling back to the
+// map. The caller locks pm->mutex and must treat a released table as gone.
+std::shared_ptr<ProcessMemory> MemoryManager::lookupProcess(int process_id, int core) {
+    CoreTlb* tlb = (core >= 0 && core < (int)tlbs.size()) ? tlbs[core].get() : nullptr;
+    std::shared_ptr<ProcessMemory>* cached = nullptr;
+    if (tlb != nullptr) {
+        cached = &tlb->processes[(unsigned)process_id % CoreTlb::kProcesses];
+        std::lock_guard<std::mutex> tlb_lock(tlb->mutex);
+        if (*cached && (*cached)->process_id == process_id && !(*cached)->released) return *cached;
+    }
+
+    std::shared_ptr<ProcessMemory> pm;
+    {
+        std::shared_lock<std::shared_mutex> tables_lock(page_tables_mutex);
+        auto it = page_tables.find(process_id);
+        if (it == page_tables.end()) return nullptr;
+        pm = it->second;
+    }
+    if (tlb != nullptr) {
+        std::lock_guard<std::mutex> tlb_lock(tlb->mutex);
+        *cached = pm;
+    }
+    return pm;
+}
+
 int MemoryManager::findFreeFrame() {
-    for (int i = 0; i < total_frames; i++) {
-        if (frames[i].is_free) {
-            return i;
+    if (free_frame_list.empty()) return -1;
+    int frame_id = free_frame_list.back();
+    free_frame_list.pop_back();
+    return frame_id;
+}
+
+// Returns a resident frame to the free list
+void MemoryManager::releaseFrame(int frame_id) {
+    Frame& frame = frames[frame_id];
+    replacement->frameReleased(frame_id);
+    frame_accessed[frame_id].store(false, std::memory_order_relaxed);
+    frame.is_free = true;
+    frame.process_id = -1;
+    frame.owner = nullptr;
+    frame.page_number = -1;
+    free_frame_list.push_back(frame_id);
+
+    counters.used_frames--;
+    counters.free_frames++;
+}
+
+void MemoryManager::notifyAccess(int frame_id) {
+    std::lock_guard<std::mutex> pool_lock(pool_mutex);
+    if (!frames[frame_id].is_free) replacement->pageAccessed(frame_id);
+}
+
+void MemoryManager::tlbFill(int core, int process_id, int page_number, int frame_id, bool writable) {
+    if (core < 0 || core >= (int)tlbs.size()) return;
+    CoreTlb& tlb = *tlbs[core];
+    std::lock_guard<std::mutex> tlb_lock(tlb.mutex);
+    tlb.entries[tlbIndex(process_id, page_number)] = { process_id, page_number, frame_id, writable };
+}
+
+// Waits out any in-flight hit on the mapping, so the frame can be reused
+void MemoryManager::tlbShootdown(int process_id, int page_number) {
+    int index = tlbIndex(process_id, page_number);
+    for (auto& tlb : tlbs) {
+        std::lock_guard<std::mutex> tlb_lock(tlb->mutex);
+        TlbEntry& entry = tlb->entries[index];
+        if (entry.process_id == process_id && entry.page_number == page_number) {
+            entry = TlbEntry();
         }
     }
-    return -1;
 }
 
-void MemoryManager::saveFrameToBackingStore(int frame_id, int process_id, int page_num) {
-    std::string key = std::to_string(process_id) + "_" + std::to_string(page_num);
-    backing_store_disk[key] = frames[frame_id].data;
-
-    // Update text file
-    std::ofstream ofs("csopesy-backing-store.txt");
-    if (ofs.is_open()) {
-        for (const auto& pair : backing_store_disk) {
-            ofs << "Key: " << pair.first << " Data: [";
-            for (size_t i = 0; i < pair.second.size(); ++i) {
-                ofs << pair.second[i] << (i < pair.second.size() - 1 ? " " : "");
-            }
-            ofs << "]\n";
+void MemoryManager::tlbFlushProcess(int process_id) {
+    for (auto& tlb : tlbs) {
+        std::lock_guard<std::mutex> tlb_lock(tlb->mutex);
+        for (auto& entry : tlb->entries) {
+            if (entry.process_id == process_id) entry = TlbEntry();
         }
-        ofs.close();
+        auto& cached = tlb->processes[(unsigned)process_id % CoreTlb::kProcesses];
+        if (cached && cached->process_id == process_id) cached.reset();
     }
 }
 
-bool MemoryManager::loadFrameFromBackingStore(int frame_id, int process_id, int page_num) {
-    std::string key = std::to_string(process_id) + "_" + std::to_string(page_num);
+// (run, value) pairs; returns false if that is no smaller than the page
+static bool compressPage(const uint16_t* page, int words, std::vector<uint16_t>& out) {
+    out.clear();
+    for (int i = 0; i < words; ) {
+        int run = 1;
+        while (i + run < words && run < 65535 && page[i + run] == page[i]) run++;
+        out.push_back((uint16_t)run);
+        out.push_back(page[i]);
+        if ((int)out.size() >= words) return false;
+        i += run;
+    }
+    return true;
+}
 
-    if (backing_store_disk.find(key) != backing_store_disk.end()) {
-        frames[frame_id].data = backing_store_disk[key];
-        return true;
+static void decompressPage(const std::vector<uint16_t>& in, uint16_t* page) {
+    for (size_t i = 0; i + 1 < in.size(); i += 2) {
+        page = std::fill_n(page, in[i], in[i + 1]);
     }
-    else {
-        std::fill(frames[frame_id].data.begin(), frames[frame_id].data.end(), 0);
-        return false;
+}
+
+void MemoryManager::releaseSwapData(SwapEntry& entry) {
+    if (entry.tier == SWAP_ZERO) counters.swap_zero_pages--;
+    if (entry.tier == SWAP_CACHE) {
+        counters.swap_cache_pages--;
+        counters.swap_cache_bytes -= (long long)entry.data.size() * sizeof(uint16_t);
     }
+    entry.data.clear();
+    entry.data.shrink_to_fit();
+    entry.tier = SWAP_NONE;
 }
 
-int MemoryManager::evictPage() {
-    uint64_t oldest_time = UINT64_MAX;
-    int victim_frame_index = -1;
+void MemoryManager::freeSwapEntry(int entry_id) {
+    SwapEntry& entry = swap_entries[entry_id];
+    releaseSwapData(entry);
+    if (entry.disk_slot != -1) swap_device.freeSlot(entry.disk_slot);
+    entry = SwapEntry();
+    free_swap_entries.push_back(entry_id);
+}
 
-    for (int i = 0; i < total_frames; i++) {
-        // [FIX]: Ensure we only check currently occupied frames
-        if (!frames[i].is_free && frames[i].last_access_time < oldest_time) {
-            oldest_time = frames[i].last_access_time;
-            victim_frame_index = i;
+// Zero pages cost nothing, compressible pages go to the swap cache while
+// it has room, and only the rest is written to disk
+void MemoryManager::saveFrameToBackingStore(int frame_id, int process_id, int page_num, PageTableEntry& pte) {
+    std::lock_guard<std::mutex> swap_lock(swap_mutex);
+
+    if (pte.swap_entry == -1) {
+        if (!free_swap_entries.empty()) {
+            pte.swap_entry = free_swap_entries.back();
+            free_swap_entries.pop_back();
         }
+        else {
+            pte.swap_entry = (int)swap_entries.size();
+            swap_entries.emplace_back();
+        }
+        swap_entries[pte.swap_entry].process_id = process_id;
+        swap_entries[pte.swap_entry].page_number = page_num;
     }
 
-    if (victim_frame_index != -1) {
-        Frame& frame = frames[victim_frame_index];
+    SwapEntry& entry = swap_entries[pte.swap_entry];
+    releaseSwapData(entry);
+    const uint16_t* page = frameData(frame_id);
 
-        // Swap Out
-        if (frame.process_id != -1 && frame.page_number != -1) {
-            saveFrameToBackingStore(victim_frame_index, frame.process_id, frame.page_number);
-        }
+    if (std::all_of(page, page + mem_per_frame, [](uint16_t word) { return word == 0; })) {
+        entry.tier = SWAP_ZERO;
+        counters.swap_zero_pages++;
+        return;
+    }
 
-        // Invalidate victim page table
-        if (page_tables.count(frame.process_id)) {
-            auto& pt = page_tables[frame.process_id];
-            if (frame.page_number < (int)pt.size()) {
-                pt[frame.page_number].valid = false;
-                pt[frame.page_number].frame_number = -1;
-            }
-        }
+    entry.raw = !compressPage(page, mem_per_frame, entry.data);
+    if (entry.raw) entry.data.assign(page, page + mem_per_frame);
+    long long bytes = (long long)entry.data.size() * sizeof(uint16_t);
 
-        stats.total_pages_out++;
+    if (counters.swap_cache_bytes + bytes <= swap_cache_limit) {
+        entry.data.shrink_to_fit();
+        entry.tier = SWAP_CACHE;
+        counters.swap_cache_pages++;
+        counters.swap_cache_bytes += bytes;
+        return;
+    }
 
-        // Temporarily mark free so handlePageFault can grab it
-        frame.is_free = true;
-        frame.process_id = -1;
-        frame.page_number = -1;
+    // Cache full: spill to disk
+    entry.data.clear();
+    entry.data.shrink_to_fit();
+    if (entry.disk_slot == -1) entry.disk_slot = swap_device.allocSlot();
+    entry.tier = SWAP_DISK;
+    counters.total_pages_out++;
 
-        if (stats.used_frames > 0) stats.used_frames--;
-        if (stats.free_frames < total_frames) stats.free_frames++;
+    if (!swap_device.writeSlot(entry.disk_slot, page)) {
+        std::cerr << "ERROR: Failed to write swap slot " << entry.disk_slot << ".\n";
     }
-
-    return victim_frame_index;
 }
 
-bool MemoryManager::handlePageFault(int process_id, int page_number) {
-    if (page_tables.find(process_id) == page_tables.end()) return false;
-    if (page_number >= (int)page_tables[process_id].size()) return false;
+SwapTier MemoryManager::loadFrameFromBackingStore(int frame_id, const PageTableEntry& pte) {
+    uint16_t* page = frameData(frame_id);
 
-    int frame_id = findFreeFrame();
+    if (pte.swap_entry != -1) {
+        std::lock_guard<std::mutex> swap_lock(swap_mutex);
+        const SwapEntry& entry = swap_entries[pte.swap_entry];
 
-    if (frame_id == -1) {
-        frame_id = evictPage();
-        if (frame_id == -1) {
-            std::cerr << "CRITICAL ERROR: Failed to find or evict a frame!\n";
-            return false;
+        if (entry.tier == SWAP_CACHE) {
+            if (entry.raw) std::copy(entry.data.begin(), entry.data.end(), page);
+            else decompressPage(entry.data, page);
+            return SWAP_CACHE;
+        }
+        if (entry.tier == SWAP_DISK && swap_device.readSlot(entry.disk_slot, page)) {
+            return SWAP_DISK;
+        }
+        if (entry.tier == SWAP_ZERO) {
+            std::memset(page, 0, mem_per_frame * sizeof(uint16_t));
+            return SWAP_ZERO;
         }
     }
+    std::memset(page, 0, mem_per_frame * sizeof(uint16_t));
+    return SWAP_NONE;
+}
 
-    // Allocate Frame
-    frames[frame_id].is_free = false;
-    frames[frame_id].process_id = process_id;
-    frames[frame_id].page_number = page_number;
-    frames[frame_id].last_access_time = getCurrentTime();
+// The policy proposes candidates; frames of other processes are only
+// try_locked (the faulting process's own lock, if any, is already held),
+// and busy ones are skipped rather than waited for. pool_mutex is dropped
+// during the write-back, while the frame is out of the policy and not yet
+// free, so no one else can pick it.
+bool MemoryManager::evictPage(ProcessMemory* faulting, std::unique_lock<std::mutex>& pool_lock) {
+    auto start = std::chrono::steady_clock::now();
+    ProcessMemory* victim = nullptr;
+    long long scanned = 0;
+
+    int victim_frame_index = replacement->selectVictim(frame_accessed.get(), [&](int frame_id) {
+        ProcessMemory* owner = frames[frame_id].owner;
+        if (owner != faulting && !owner->mutex.try_lock()) return false;
+        victim = owner;
+        return true;
+    }, scanned);
+    counters.frames_scanned += scanned;
+    if (victim_frame_index == -1) return false;
+
+    Frame& frame = frames[victim_frame_index];
+    int process_id = frame.process_id;
+    int page_number = frame.page_number;
+    PageTableEntry& pte = victim->pages[page_number];
+    replacement->frameReleased(victim_frame_index);
+    pool_lock.unlock();
+
+    tlbShootdown(process_id, page_number);
+
+    // Swap Out. A clean page either still has a valid swap copy or was
+    // never written at all (reloads as zeros), so it is simply dropped.
+    if (pte.dirty) {
+        saveFrameToBackingStore(victim_frame_index, process_id, page_number, pte);
+        counters.dirty_evictions++;
+    }
+    else {
+        counters.clean_evictions++;
+    }
 
-    // Swap In
-    bool was_paged_in = loadFrameFromBackingStore(frame_id, process_id, page_number);
+    // A prefetch that was never used shrinks its process's window
+    if (pte.prefetched) {
+        counters.prefetch_wasted++;
+        victim->prefetch_window = std::max(1, victim->prefetch_window / 2);
+        pte.prefetched = false;
+    }
 
-    // Update Page Table
-    page_tables[process_id][page_number].valid = true;
-    page_tables[process_id][page_number].frame_number = frame_id;
-    page_tables[process_id][page_number].last_access_time = getCurrentTime();
+    // Invalidate victim page table
+    pte.valid = false;
+    pte.dirty = false;
+    pte.referenced = false;
+    pte.frame_number = -1;
+    if (victim != faulting) victim->mutex.unlock();
 
-    stats.used_frames++;
-    stats.free_frames--;
-    stats.total_page_faults++;
+    pool_lock.lock();
+    releaseFrame(victim_frame_index);
 
-    if (was_paged_in) {
-        stats.total_pages_in++;  // Only count actual disk reads
-    }
+    counters.eviction_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    return true;
+}
 
+bool MemoryManager::handlePageFault(int process_id, int page_number) {
+    std::shared_lock<std::shared_mutex> tables_lock(page_tables_mutex);
+    ProcessMemory* pm = findProcess(process_id);
+    if (pm == nullptr) return false;
 
-    return true;
+    std::lock_guard<std::mutex> lock(pm->mutex);
+    if (page_number < 0 || page_number >= (int)pm->pages.size()) return false;
+    return pm->pages[page_number].valid || faultIn(*pm, page_number);
 }
 
-bool MemoryManager::readMemory(int process_id, int virtual_address, uint16_t& value) {
-    std::lock_guard<std::mutex> lock(memory_mutex);
+int MemoryManager::getPageFaults(int process_id) {
+    std::shared_lock<std::shared_mutex> tables_lock(page_tables_mutex);
+    ProcessMemory* pm = findProcess(process_id);
+    if (pm == nullptr) return 0;
 
-    if (page_tables.find(process_id) == page_tables.end()) return false;
+    std::lock_guard<std::mutex> lock(pm->mutex);
+    return pm->page_faults;
+}
 
+bool MemoryManager::isResident(int process_id, int virtual_address, int core) {
+    if (!initialized) return true;
     int page_number = virtual_address / mem_per_frame;
-    int offset = virtual_address % mem_per_frame;
 
-    if (page_number >= (int)page_tables[process_id].size()) return false;
+    if (core >= 0 && core < (int)tlbs.size()) {
+        CoreTlb& tlb = *tlbs[core];
+        std::lock_guard<std::mutex> tlb_lock(tlb.mutex);
+        const TlbEntry& entry = tlb.entries[tlbIndex(process_id, page_number)];
+        if (entry.process_id == process_id && entry.page_number == page_number) return true;
+    }
+
+    std::shared_ptr<ProcessMemory> pm = lookupProcess(process_id, core);
+    if (pm == nullptr) return true;
+
+    std::lock_guard<std::mutex> lock(pm->mutex);
+    if (pm->released || page_number < 0 || page_number >= (int)pm->pages.size()) return true;
+    return pm->pages[page_number].valid;
+}
+
+bool MemoryManager::faultIn(ProcessMemory& pm, int page_number) {
+    int frame_id = -1;
+    {
+        std::unique_lock<std::mutex> pool_lock(pool_mutex);
+        frame_id = findFreeFrame();
+
+        // Direct reclaim. Every evictable frame may belong to a process
+        // that is busy right now; back off and let it finish. Another
+        // fault may also take the freed frame first.
+        for (int attempt = 0; frame_id == -1 && total_frames > 0; attempt++) {
+            if (evictPage(&pm, pool_lock)) {
+                counters.direct_reclaims++;
+            }
+            else {
+                if (attempt >= 1000) {
+                    std::cerr << "CRITICAL ERROR: Failed to find or evict a frame!\n";
+                    return false;
+                }
+                pool_lock.unlock();
+                std::this_thread::yield();
+                pool_lock.lock();
+            }
+            frame_id = findFreeFrame();
+        }
+        if (frame_id == -1) return false;
 
-    if (!page_tables[process_id][page_number].valid) {
-        if (!handlePageFault(process_id, page_number)) return false;
+        assignFrame(pm, page_number, frame_id);
+        if ((int)free_frame_list.size() < free_frames_low) reclaim_cv.notify_one();
     }
 
-    int frame_id = page_tables[process_id][page_number].frame_number;
+    // Swap In
+    PageTableEntry& pte = pm.pages[page_number];
+    bool was_paged_in = loadFrameFromBackingStore(frame_id, pte) == SWAP_DISK;
 
-    // Update LRU
-    frames[frame_id].last_access_time = getCurrentTime();
-    page_tables[process_id][page_number].last_access_time = getCurrentTime();
+    // Update Page Table
+    pte.valid = true;
+    pte.dirty = false;
+    pte.frame_number = frame_id;
 
-    // Read Data
-    if (offset < frames[frame_id].data.size()) {
-        value = frames[frame_id].data[offset];
-        return true;
+    counters.total_page_faults++;
+    pm.page_faults++;
+
+    if (was_paged_in) {
+        counters.total_pages_in++;  // Only count actual disk reads
     }
 
-    return false; // Offset out of bounds
+    if (pm.prefetch_window > 0) prefetchAround(pm, page_number);
+
+    return true;
 }
 
-bool MemoryManager::writeMemory(int process_id, int virtual_address, uint16_t value) {
-    std::lock_guard<std::mutex> lock(memory_mutex);
+// Allocate Frame. Evictors cannot take it before it is filled: they would
+// have to lock pm first.
+void MemoryManager::assignFrame(ProcessMemory& pm, int page_number, int frame_id) {
+    frames[frame_id].is_free = false;
+    frames[frame_id].process_id = pm.process_id;
+    frames[frame_id].owner = &pm;
+    frames[frame_id].page_number = page_number;
+    replacement->pageLoaded(frame_id);
+    counters.used_frames++;
+    counters.free_frames--;
+}
 
-    if (page_tables.find(process_id) == page_tables.end()) {
-        std::cerr << "Write Fail: PID " << process_id << " not found in page tables.\n";
-        return false;
+// Fault-around: loads the non-resident pages right after page_number, but
+// only into free frames; a prefetch never evicts anything
+void MemoryManager::prefetchAround(ProcessMemory& pm, int page_number) {
+    int last_page = std::min(page_number + pm.prefetch_window, (int)pm.pages.size() - 1);
+
+    for (int page = page_number + 1; page <= last_page; page++) {
+        PageTableEntry& pte = pm.pages[page];
+        if (pte.valid) continue;
+
+        int frame_id = -1;
+        {
+            std::lock_guard<std::mutex> pool_lock(pool_mutex);
+            frame_id = findFreeFrame();
+            if (frame_id == -1) return;
+            assignFrame(pm, page, frame_id);
+        }
+
+        if (loadFrameFromBackingStore(frame_id, pte) == SWAP_DISK) {
+            counters.total_pages_in++;
+        }
+        pte.valid = true;
+        pte.dirty = false;
+        pte.prefetched = true;
+        pte.frame_number = frame_id;
+        counters.pages_prefetched++;
     }
+}
+
+bool MemoryManager::readMemory(int process_id, int virtual_address, uint16_t& value, int core) {
+    return access(process_id, virtual_address, value, false, core);
+}
+
+bool MemoryManager::writeMemory(int process_id, int virtual_address, uint16_t value, int core) {
+    return access(process_id, virtual_address, value, true, core);
+}
+
+bool MemoryManager::access(int process_id, int virtual_address, uint16_t& value, bool is_write, int core) {
+    if (!initialized) return false;
 
     int page_number = virtual_address / mem_per_frame;
     int offset = virtual_address % mem_per_frame;
 
-    if (page_number >= (int)page_tables[process_id].size()) {
-        std::cerr << "Write Fail: Page " << page_number << " out of bounds.\n";
+    // TLB. Only entries for already-dirty pages accept writes; the first
+    // write to a clean page takes the slow path to set the dirty bit.
+    if (core >= 0 && core < (int)tlbs.size()) {
+        int hit_frame = -1;
+        {
+            CoreTlb& tlb = *tlbs[core];
+            std::lock_guard<std::mutex> tlb_lock(tlb.mutex);
+            const TlbEntry& entry = tlb.entries[tlbIndex(process_id, page_number)];
+            if (entry.process_id == process_id && entry.page_number == page_number && (entry.writable || !is_write)) {
+                tlb.hits.fetch_add(1, std::memory_order_relaxed);
+                hit_frame = entry.frame_id;
+                frame_accessed[hit_frame].store(true, std::memory_order_relaxed);
+                if (is_write) frameData(hit_frame)[offset] = value;
+                else value = frameData(hit_frame)[offset];
+            }
+            else {
+                tlb.misses.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        if (hit_frame != -1) {
+            // Taken after the TLB lock (pool_mutex comes first in the lock
+            // order); the frame may have been reused since, which only
+            // costs exact LRU a little precision
+            if (track_accesses) notifyAccess(hit_frame);
+            return true;
+        }
+    }
+
+    std::shared_ptr<ProcessMemory> pm = lookupProcess(process_id, core);
+    std::unique_lock<std::mutex> lock;
+    if (pm != nullptr) lock = std::unique_lock<std::mutex>(pm->mutex);
+    if (pm == nullptr || pm->released) {
+        if (is_write) std::cerr << "Write Fail: PID " << process_id << " not found in page tables.\n";
         return false;
     }
 
-    if (!page_tables[process_id][page_number].valid) {
-        if (!handlePageFault(process_id, page_number)) {
-            std::cerr << "Write Fail: Page Fault handling failed.\n";
-            return false;
-        }
+    if (page_number < 0 || page_number >= (int)pm->pages.size()) {
+        if (is_write) std::cerr << "Write Fail: Page " << page_number << " out of bounds.\n";
+        return false;
     }
 
-    int frame_id = page_tables[process_id][page_number].frame_number;
+    PageTableEntry& pte = pm->pages[page_number];
+    if (!pte.valid && !faultIn(*pm, page_number)) {
+        if (is_write) std::cerr << "Write Fail: Page Fault handling failed.\n";
+        return false;
+    }
 
-    // Update LRU
-    frames[frame_id].last_access_time = getCurrentTime();
-    page_tables[process_id][page_number].last_access_time = getCurrentTime();
+    if (pte.prefetched) {
+        pte.prefetched = false;
+        counters.prefetch_hits++;
+        pm->prefetch_window = std::min(prefetch_pages, pm->prefetch_window + 1);
+    }
 
-    // Write Data
-    if (offset < frames[frame_id].data.size()) {
-        frames[frame_id].data[offset] = value;
-        // DEBUG PRINT
-        // std::cout << "Debug: Wrote " << value << " to Frame " << frame_id << " offset " << offset << "\n";
-        return true;
+    // A hit only sets the reference bit, so hits never take pool_mutex
+    // unless the policy tracks every access
+    int frame_id = pte.frame_number;
+    pte.referenced = true;
+    frame_accessed[frame_id].store(true, std::memory_order_relaxed);
+    if (track_accesses) notifyAccess(frame_id);
+    if (core >= 0 && core < (int)tlbs.size()) tlbs[core]->table_accesses.fetch_add(1, std::memory_order_relaxed);
+    else counters.page_table_accesses.fetch_add(1, std::memory_order_relaxed);
+
+    if (is_write) {
+        frameData(frame_id)[offset] = value;
+        pte.dirty = true;
     }
     else {
-        std::cerr << "Write Fail: Offset " << offset << " out of frame bounds (" << frames[frame_id].data.size() << ")\n";
-        return false;
+        value = frameData(frame_id)[offset];
     }
-}
-
-uint64_t MemoryManager::getCurrentTime() {
-    return ++access_counter;
+    tlbFill(core, process_id, page_number, frame_id, pte.dirty);
+    return true;
 }
 
 MemoryStats MemoryManager::getStats() {
-    std::lock_guard<std::mutex> lock(memory_mutex);
+    MemoryStats stats;
+    stats.total_frames = total_frames;
+    stats.used_frames = counters.used_frames;
+    stats.free_frames = counters.free_frames;
+    stats.total_page_faults = counters.total_page_faults;
+    stats.total_pages_in = counters.total_pages_in;
+    stats.total_pages_out = counters.total_pages_out;
+    stats.clean_evictions = counters.clean_evictions;
+    stats.dirty_evictions = counters.dirty_evictions;
+    stats.swap_slots_total = swap_device.totalSlots();
+    stats.swap_slots_used = swap_device.usedSlots();
+    for (auto& tlb : tlbs) {
+        stats.tlb_hits += tlb->hits;
+        stats.tlb_misses += tlb->misses;
+        stats.accesses += tlb->table_accesses;
+    }
+    stats.accesses += stats.tlb_hits + counters.page_table_accesses;
+    stats.eviction_ns = counters.eviction_ns;
+    stats.frames_scanned = counters.frames_scanned;
+    stats.replacement_policy = replacement ? replacement->name() : "";
+    stats.pages_prefetched = counters.pages_prefetched;
+    stats.prefetch_hits = counters.prefetch_hits;
+    stats.prefetch_wasted = counters.prefetch_wasted;
+    stats.background_reclaims = counters.background_reclaims;
+    stats.direct_reclaims = counters.direct_reclaims;
+    stats.swap_zero_pages = counters.swap_zero_pages;
+    stats.swap_cache_pages = counters.swap_cache_pages;
+    stats.swap_cache_bytes = counters.swap_cache_bytes;
+    stats.swap_cache_limit = swap_cache_limit;
     return stats;
 }
 
+int MemoryManager::dumpBackingStore(const std::string& filename) {
+    std::lock_guard<std::mutex> swap_lock(swap_mutex);
+
+    std::ofstream ofs(filename);
+    if (!ofs.is_open()) return -1;
+
+    static const char* tier_names[] = { "none", "zero", "cache", "disk" };
+    std::vector<uint16_t> page(mem_per_frame);
+    int pages = 0;
+    for (const SwapEntry& entry : swap_entries) {
+        if (entry.tier == SWAP_NONE) continue;
+        if (entry.tier == SWAP_ZERO) std::fill(page.begin(), page.end(), 0);
+        else if (entry.tier == SWAP_CACHE && entry.raw) page = entry.data;
+        else if (entry.tier == SWAP_CACHE) decompressPage(entry.data, page.data());
+        else if (!swap_device.readSlot(entry.disk_slot, page.data())) continue;
+
+        ofs << "Key: " << entry.process_id << "_" << entry.page_number << " Tier: " << tier_names[entry.tier];
+        if (entry.tier == SWAP_DISK) ofs << " Slot: " << entry.disk_slot;
+        ofs << " Data: [";
+        for (size_t i = 0; i < page.size(); ++i) {
+            ofs << page[i] << (i < page.size() - 1 ? " " : "");
+        }
+        ofs << "]\n";
+        pages++;
+    }
+    return pages;
+}
+
 void MemoryManager::printMemorySnapshot() {
-    std::lock_guard<std::mutex> lock(memory_mutex);
+    std::lock_guard<std::mutex> pool_lock(pool_mutex);
     std::cout << "\n=== Memory Snapshot ===\n";
-    std::cout << "Used Frames: " << stats.used_frames << " / " << total_frames << "\n";
-    std::cout << "Page Faults: " << stats.total_page_faults << "\n";
+    std::cout << "Used Frames: " << counters.used_frames << " / " << total_frames << "\n";
+    std::cout << "Page Faults: " << counters.total_page_faults << "\n";
     std::cout << "+-------+----------+----------+\n";
     std::cout << "| Frame | Process  | Page     |\n";
     std::cout << "+-------+----------+----------+\n";
@@ -345,8 +872,49 @@ void MemoryManager::printMemorySnapshot() {
 }
 
 int MemoryManager::getFrameForProcess(int process_id, int page_number) {
-    std::lock_guard<std::mutex> lock(memory_mutex);
-    if (page_tables.count(process_id) && page_number < page_tables[process_id].size() && page_tables[process_id][page_number].valid)
-        return page_tables[process_id][page_number].frame_number;
+    std::shared_lock<std::shared_mutex> tables_lock(page_tables_mutex);
+    ProcessMemory* pm = findProcess(process_id);
+    if (pm == nullptr) return -1;
+
+    std::lock_guard<std::mutex> lock(pm->mutex);
+    if (page_number >= 0 && page_number < (int)pm->pages.size() && pm->pages[page_number].valid)
+        return pm->pages[page_number].frame_number;
     return -1;
 }
+
+// Each thread owns a synthetic process (pids far above any real one) sized
+// to stay resident, so the run measures lock contention, not paging.
+double MemoryManager::runContentionBenchmark(int threads, int accesses_per_thread) {
+    if (!initialized || threads < 1) return 0.0;
+
+    // A private pool with this one's frame size and policy, so the
+    // synthetic processes never evict real pages or skew vmstat. Each gets
+    // twice as many pages as a TLB holds, all resident, so accesses split
+    // between TLB hits and page-table hits.
+    int pages_per_thread = 2 * CoreTlb::kEntries;
+    int words = pages_per_thread * mem_per_frame;
+    MemoryManager bench;
+    bench.resetPool(threads * words, mem_per_frame, threads, replacement ? replacement->name() : "clock");
+    bench.initialized = true;
+    for (int t = 0; t < threads; t++) {
+        bench.allocateMemory(t, words);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&bench, t, words, accesses_per_thread]() {
+            uint32_t state = 2463534242u + t;
+            uint16_t value = 0;
+            for (int i = 0; i < accesses_per_thread; i++) {
+                state ^= state << 13; state ^= state >> 17; state ^= state << 5;
+                int address = state % words;
+                if (i % 4 == 0) bench.writeMemory(t, address, (uint16_t)i, t);
+                else bench.readMemory(t, address, value, t);
+            }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return seconds > 0 ? (double)threads * accesses_per_thread / seconds : 0.0;
+}
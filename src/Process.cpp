@@ -7,104 +7,205 @@
 #include <sstream>
 #include <algorithm>
 #include <iostream>
+#include <climits>
 
 
 // ============ ProcessGenerator Implementation ============
 ProcessGenerator::ProcessGenerator() : rng(std::random_device{}()) {}
 
-Instruction ProcessGenerator::makeRandomInstruction(int depth, int memory_size) {
-    Instruction inst;
-    int type = (depth >= 3) ? (rng() % 5) : (rng() % 6);
+// xorshift64* - a few bytes of state, so a process only has to remember its seed
+uint32_t ProcessGenerator::nextRandom(uint64_t& state) {
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return (uint32_t)((state * 0x2545F4914F6CDD1DULL) >> 32);
+}
+
+// Appends one random instruction of at most `budget` ops (a FOR_LOOP
+// counts its LOOP, body and ENDLOOP ops). Returns the number of ops added.
+// The type is drawn from the instruction-mix weights.
+int ProcessGenerator::makeRandomInstruction(WorkloadState& w, int depth, int budget, std::vector<Op>& out) {
+    uint64_t& state = w.rng;
+    Op op;
+    bool allow_loop = depth < 3 && budget >= 3;
+
+    int total = 0;
+    for (int i = 0; i < 8; i++) {
+        if (i != 5 || allow_loop) total += w.mix[i];
+    }
+    int type = 0;
+    if (total > 0) {
+        int pick = nextRandom(state) % total;
+        for (type = 0; type < 8; type++) {
+            if (type == 5 && !allow_loop) continue;
+            if (pick < w.mix[type]) break;
+            pick -= w.mix[type];
+        }
+    }
 
     switch (type) {
     case 0: // PRINT
-        inst.type = PRINT;
-        inst.var = "";
+        op.opcode = OP_PRINT;
         break;
 
     case 1: // DECLARE
-        inst.type = DECLARE;
-        inst.var1 = "x" + std::to_string(rng() % 5);
-        inst.value2 = rng() % 500;
+        op.opcode = OP_DECLARE;
+        op.dst = nextRandom(state) % 5;
+        op.flags = OPF_IMM_A | OPF_IMM_B;
+        op.a = nextRandom(state) % 500;
         break;
 
     case 2: // ADD
-        inst.type = ADD;
-        inst.var1 = "x" + std::to_string(rng() % 5);
-        inst.isVar2 = (rng() % 2) == 0;
-        inst.isVar3 = (rng() % 2) == 0;
-        if (inst.isVar2) {
-            inst.var2 = "x" + std::to_string(rng() % 5);
-        }
-        else {
-            inst.value2 = rng() % 500;
-        }
-        if (inst.isVar3) {
-            inst.var3 = "x" + std::to_string(rng() % 5);
-        }
-        else {
-            inst.value3 = rng() % 500;
-        }
-        break;
-
     case 3: // SUBTRACT
-        inst.type = SUBTRACT;
-        inst.var1 = "x" + std::to_string(rng() % 5);
-        inst.isVar2 = (rng() % 2) == 0;
-        inst.isVar3 = (rng() % 2) == 0;
-        if (inst.isVar2) {
-            inst.var2 = "x" + std::to_string(rng() % 5);
+        op.opcode = (type == 2) ? OP_ADD : OP_SUBTRACT;
+        op.dst = nextRandom(state) % 5;
+        if (nextRandom(state) % 2 == 0) {
+            op.a = nextRandom(state) % 5;
         }
         else {
-            inst.value2 = rng() % 500;
+            op.flags |= OPF_IMM_A;
+            op.a = nextRandom(state) % 500;
         }
-        if (inst.isVar3) {
-            inst.var3 = "x" + std::to_string(rng() % 5);
+        if (nextRandom(state) % 2 == 0) {
+            op.b = nextRandom(state) % 5;
         }
         else {
-            inst.value3 = rng() % 500;
+            op.flags |= OPF_IMM_B;
+            op.b = nextRandom(state) % 500;
         }
         break;
 
     case 4: // SLEEP
-        inst.type = SLEEP;
-        inst.sleepTicks = (rng() % 5) + 1;
+        op.opcode = OP_SLEEP;
+        op.a = (nextRandom(state) % 5) + 1;
         break;
 
-    case 5: { // FOR_LOOP 
-        inst.type = FOR_LOOP;
-        inst.repeatCount = (rng() % 3) + 2;
-        int nested_count = (rng() % 3) + 1;
-        for (int i = 0; i < nested_count; i++) {
-            inst.nestedInstructions.push_back(makeRandomInstruction(depth + 1));
+    case 5: { // FOR_LOOP
+        size_t loop_at = out.size();
+        op.opcode = OP_LOOP;
+        op.dst = depth;
+        op.a = (nextRandom(state) % 3) + 2;
+        out.push_back(op);
+
+        int remaining = budget - 2;
+        int nested_count = (nextRandom(state) % 3) + 1;
+        for (int i = 0; i < nested_count && remaining > 0; i++) {
+            remaining -= makeRandomInstruction(w, depth + 1, remaining, out);
         }
-        break;
+
+        Op end;
+        end.opcode = OP_ENDLOOP;
+        end.dst = depth;
+        end.a = out.size() - (loop_at + 1);
+        out.push_back(end);
+
+        out[loop_at].b = out.size() - loop_at;
+        return out.size() - loop_at;
     }
 
     case 6: // READ
-        inst.type = READ;
-        inst.var = "x" + std::to_string(rng() % 5);
-        if (memory_size > 0) {
-            inst.memory_address = rng() % memory_size;
-        }
-        else {
-            inst.memory_address = 0;
-        }
+        op.opcode = OP_READ;
+        op.dst = nextRandom(state) % 5;
+        op.a = makeAddress(w, w.op_base + (int)(out.size() - w.out_start));
         break;
 
     case 7: // WRITE
-        inst.type = WRITE;
-        if (memory_size > 0) {
-            inst.memory_address = rng() % memory_size;
-        }
-        else {
-            inst.memory_address = 0;
-        }
-        inst.write_value = rng() % 65536;
+        op.opcode = OP_WRITE;
+        op.a = makeAddress(w, w.op_base + (int)(out.size() - w.out_start));
+        op.b = nextRandom(state) % 65536;
         break;
     }
 
-    return inst;
+    out.push_back(op);
+    return 1;
+}
+
+// Addresses depend only on the chunk's random state, the op's index in the
+// process and the seed, so regenerated chunks repeat them exactly
+uint16_t ProcessGenerator::makeAddress(WorkloadState& w, int op_index) {
+    if (w.memory_size <= 0) return 0;
+    int pages = std::max(1, (w.memory_size + w.page_size - 1) / w.page_size);
+
+    switch (w.pattern) {
+    case ACCESS_SEQUENTIAL:
+        // One pass over memory every memory_size / 4 ops
+        return (uint16_t)(((long long)op_index * 4) % w.memory_size);
+
+    case ACCESS_ZIPF: {
+        // Page rank r is chosen with weight 1/r: page 0 is the hot spot
+        double pick = (nextRandom(w.rng) / 4294967296.0) * w.zipf_cdf.back();
+        int page = (int)(std::upper_bound(w.zipf_cdf.begin(), w.zipf_cdf.end(), pick) - w.zipf_cdf.begin());
+        page = std::min(page, pages - 1);
+        int address = page * w.page_size + nextRandom(w.rng) % w.page_size;
+        return (uint16_t)(std::min(address, w.memory_size - 1));
+    }
+
+    case ACCESS_PHASED: {
+        // Every 1024 ops the process moves to a new working set of a
+        // quarter of its pages, chosen by hashing (seed, phase)
+        const int kPhaseLength = 1024;
+        uint64_t phase_state = (w.seed ^ ((uint64_t)(op_index / kPhaseLength + 1) * 0x9E3779B97F4A7C15ULL)) | 1;
+        int window = std::max(1, pages / 4);
+        int first_page = nextRandom(phase_state) % pages;
+        int page = (first_page + nextRandom(w.rng) % window) % pages;
+        int address = page * w.page_size + nextRandom(w.rng) % w.page_size;
+        return (uint16_t)(std::min(address, w.memory_size - 1));
+    }
+
+    case ACCESS_UNIFORM:
+    default:
+        return (uint16_t)(nextRandom(w.rng) % w.memory_size);
+    }
+}
+
+void ProcessGenerator::emitChunk(uint64_t seed, const WorkloadParams& params, int chunk, int length,
+    int memory_size, std::vector<Op>& out) {
+    WorkloadState w;
+
+    // splitmix64 of (seed, chunk) so neighbouring chunks are unrelated
+    uint64_t state = seed + (uint64_t)(chunk + 1) * 0x9E3779B97F4A7C15ULL;
+    state = (state ^ (state >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    state = (state ^ (state >> 27)) * 0x94D049BB133111EBULL;
+    w.rng = (state ^ (state >> 31)) | 1;
+
+    w.seed = seed;
+    w.memory_size = memory_size;
+    w.page_size = params.page_size;
+    w.op_base = chunk * kCodeChunk;
+    w.out_start = out.size();
+    w.mix = params.mix;
+    w.pattern = params.pattern;
+
+    if (w.pattern == ACCESS_ZIPF && memory_size > 0) {
+        int pages = std::max(1, (memory_size + w.page_size - 1) / w.page_size);
+        double sum = 0;
+        for (int rank = 1; rank <= pages; rank++) {
+            sum += 1.0 / rank;
+            w.zipf_cdf.push_back(sum);
+        }
+    }
+
+    int remaining = length;
+    while (remaining > 0) {
+        remaining -= makeRandomInstruction(w, 0, remaining, out);
+    }
+}
+
+void ProcessGenerator::loadCodeChunk(PCB& p) {
+    int chunk = p.pc / kCodeChunk;
+    int length = std::min(kCodeChunk, p.total_instructions - chunk * kCodeChunk);
+
+    p.code.clear();
+    p.code.reserve(kCodeChunk);
+    emitChunk(p.code_seed, p.workload, chunk, length, p.memory_size, p.code);
+    p.code_base = chunk * kCodeChunk;
+
+    // Loops never cross a chunk, so chunks load in order
+    if (chunk == p.sized_chunks) {
+        long long expanded = (long long)p.expanded_length - length + InstructionExecutor::expandedLength(p.code);
+        p.expanded_length = (int)std::min<long long>(expanded, INT_MAX);
+        p.sized_chunks++;
+    }
 }
 
 Instruction ProcessGenerator::parseInstruction(const std::string& inst_str) {
@@ -212,8 +313,29 @@ PCB* ProcessGenerator::createRandomProcess(int pid, int memory_size) {
         (rng() % (config.getMaxIns() - config.getMinIns() + 1));
     p->total_instructions = num_instructions;
 
-    for (int i = 0; i < num_instructions; i++) {
-        p->instructions.push_back(makeRandomInstruction(0, memory_size));
+    static const auto random_symbols = std::make_shared<const std::vector<std::string>>(
+        std::vector<std::string>{ "x0", "x1", "x2", "x3", "x4" });
+    p->symbols = random_symbols;
+
+    std::copy(config.getInstructionMix(), config.getInstructionMix() + 8, p->workload.mix);
+    p->workload.pattern = config.getAccessPattern();
+    p->workload.page_size = std::max(1, config.getMemPerFrame());
+
+    uint64_t seed = ((uint64_t)rng() << 32 | rng()) | 1;
+    if (config.getLazyInstructions()) {
+        // Nothing is kept until the process first runs. Until then the loops
+        // are unknown, so each chunk counts at its declared length and is
+        // resized when it first loads.
+        p->code_seed = seed;
+        p->expanded_length = num_instructions;
+    }
+    else {
+        p->code.reserve(num_instructions);
+        for (int chunk = 0; chunk * kCodeChunk < num_instructions; chunk++) {
+            int length = std::min(kCodeChunk, num_instructions - chunk * kCodeChunk);
+            emitChunk(seed, p->workload, chunk, length, memory_size, p->code);
+        }
+        p->expanded_length = InstructionExecutor::expandedLength(p->code);
     }
 
     return p;
@@ -250,107 +372,395 @@ PCB* ProcessGenerator::createCustomProcess(const std::string& name, int pid, int
     }
 
     // Parse each instruction
-    for (const auto& inst : inst_list) {
-        try {
-            p->instructions.push_back(parseInstruction(inst));
+    std::vector<Instruction> program;
+    try {
+        for (const auto& inst : inst_list) {
+            program.push_back(parseInstruction(inst));
         }
-        catch (const std::exception& e) {
-            delete p;
-            throw;
+        BytecodeCompiler::compile(program, *p);
+    }
+    catch (const std::exception& e) {
+        delete p;
+        throw;
+    }
+
+    return p;
+}
+
+// ============ BytecodeCompiler Implementation ============
+void BytecodeCompiler::compile(const std::vector<Instruction>& program, PCB& p) {
+    BytecodeCompiler compiler(p);
+    p.code.clear();
+    for (const auto& inst : program) {
+        compiler.emit(inst, 0);
+    }
+    p.code.shrink_to_fit();
+    p.symbols = std::make_shared<const std::vector<std::string>>(std::move(compiler.symbols));
+    p.pc = 0;
+    p.total_instructions = p.code.size();
+    p.expanded_length = InstructionExecutor::expandedLength(p.code);
+}
+
+uint8_t BytecodeCompiler::destination(const std::string& name) {
+    auto it = slots.find(name);
+    if (it != slots.end()) return it->second;
+    if ((int)symbols.size() >= kMaxVars) return kSinkSlot;
+
+    uint8_t slot = symbols.size();
+    symbols.push_back(name);
+    slots[name] = slot;
+    return slot;
+}
+
+void BytecodeCompiler::source(bool isVar, const std::string& name, uint16_t value, uint8_t imm_flag,
+    uint8_t& flags, uint16_t& operand) {
+    if (isVar) {
+        uint8_t slot = destination(name);
+        if (slot != kSinkSlot) {
+            operand = slot;
+            return;
         }
+        value = 0; // Variable table full: reads as 0
     }
+    flags |= imm_flag;
+    operand = value;
+}
 
-    p->total_instructions = p->instructions.size();
+// Processes are at most 65536 bytes, so every valid address fits in 16 bits
+uint16_t BytecodeCompiler::address(int memory_address) {
+    if (memory_address < 0 || memory_address > UINT16_MAX) {
+        throw std::runtime_error("invalid memory address");
+    }
+    return memory_address;
+}
 
-    return p;
+void BytecodeCompiler::emit(const Instruction& inst, int depth) {
+    Op op;
+
+    switch (inst.type) {
+    case PRINT:
+        op.opcode = OP_PRINT;
+        if (!inst.var.empty()) {
+            op.flags = OPF_VAR;
+            op.dst = destination(inst.var);
+        }
+        break;
+
+    case DECLARE:
+        op.opcode = OP_DECLARE;
+        op.dst = destination(inst.var1);
+        op.flags = OPF_IMM_A | OPF_IMM_B;
+        op.a = inst.value2;
+        break;
+
+    case ADD:
+    case SUBTRACT:
+        op.opcode = (inst.type == ADD) ? OP_ADD : OP_SUBTRACT;
+        op.dst = destination(inst.var1);
+        source(inst.isVar2, inst.var2, inst.value2, OPF_IMM_A, op.flags, op.a);
+        source(inst.isVar3, inst.var3, inst.value3, OPF_IMM_B, op.flags, op.b);
+        break;
+
+    case SLEEP:
+        op.opcode = OP_SLEEP;
+        op.a = inst.sleepTicks;
+        break;
+
+    case FOR_LOOP: {
+        if (depth >= kMaxLoopDepth) {
+            throw std::runtime_error("loop nesting too deep");
+        }
+
+        size_t loop_at = p.code.size();
+        op.opcode = OP_LOOP;
+        op.dst = depth;
+        op.a = inst.repeatCount > 0 ? inst.repeatCount : 0;
+        p.code.push_back(op);
+
+        for (const auto& nested : inst.nestedInstructions) {
+            emit(nested, depth + 1);
+        }
+
+        Op end;
+        end.opcode = OP_ENDLOOP;
+        end.dst = depth;
+        end.a = p.code.size() - (loop_at + 1);
+        p.code.push_back(end);
+
+        p.code[loop_at].b = p.code.size() - loop_at;
+        return;
+    }
+
+    case READ:
+        op.opcode = OP_READ;
+        op.dst = destination(inst.var);
+        op.a = address(inst.memory_address);
+        break;
+
+    case WRITE:
+        op.opcode = OP_WRITE;
+        op.a = address(inst.memory_address);
+        op.b = inst.write_value;
+        break;
+    }
+
+    p.code.push_back(op);
 }
 
 // ============ InstructionExecutor Implementation ============
-void InstructionExecutor::execute(PCB& p, Instruction& inst) {
+int InstructionExecutor::memoryOperand(PCB& p) {
+    if (p.code_seed != 0 && (p.pc < p.code_base || p.pc >= p.code_base + (int)p.code.size())) {
+        ProcessGenerator::loadCodeChunk(p);
+    }
+    const Op& op = p.code[p.pc - p.code_base];
+    return (op.opcode == OP_READ || op.opcode == OP_WRITE) ? op.a : -1;
+}
+
+int InstructionExecutor::expandedLength(const std::vector<Op>& code) {
+    // Multiplier of each open loop; a LOOP's b is the distance to just
+    // past its ENDLOOP
+    long long count = 0;
+    std::vector<std::pair<size_t, long long>> open; // (end, passes)
+    long long passes = 1;
+    for (size_t i = 0; i < code.size(); i++) {
+        while (!open.empty() && i >= open.back().first) {
+            open.pop_back();
+            passes = open.empty() ? 1 : open.back().second;
+        }
+        count += passes;
+        if (code[i].opcode == OP_LOOP && code[i].a > 0) {
+            passes = std::min<long long>(passes * code[i].a, INT_MAX);
+            open.push_back({ i + code[i].b, passes });
+        }
+        else if (code[i].opcode == OP_LOOP) {
+            i += code[i].b - 1; // Skipped body
+        }
+    }
+    return (int)std::min<long long>(count, INT_MAX);
+}
+
+void InstructionExecutor::execute(PCB& p) {
     MemoryManager& mm = MemoryManager::getInstance();
+    if (p.code_seed != 0 && (p.pc < p.code_base || p.pc >= p.code_base + (int)p.code.size())) {
+        ProcessGenerator::loadCodeChunk(p);
+    }
+    const Op& op = p.code[p.pc - p.code_base];
+    int next_pc = p.pc + 1;
 
-    switch (inst.type) {
-    case PRINT: {
-        std::string output;
-        if (!inst.var.empty()) {
-            output = "Hello world from " + p.name + "! Value: " +
-                std::to_string(p.vars[inst.var]);
+    switch (op.opcode) {
+    case OP_PRINT:
+        if (op.flags & OPF_VAR) {
+            p.log.push(LOG_PRINT_VALUE, op.dst, 0, p.regs[op.dst]);
         }
         else {
-            output = "Hello world from " + p.name + "!";
+            p.log.push(LOG_PRINT);
         }
-        p.screenBuffer.push_back("(" + Utils::getTimestamp() + ") " + output);
         break;
-    }
 
-    case DECLARE:
-        p.vars[inst.var1] = inst.value2;
+    case OP_DECLARE:
+        p.regs[op.dst] = op.a;
         break;
 
-    case ADD: {
-        uint16_t a = inst.isVar2 ? p.vars[inst.var2] : inst.value2;
-        uint16_t b = inst.isVar3 ? p.vars[inst.var3] : inst.value3;
-        p.vars[inst.var1] = a + b;
+    case OP_ADD: {
+        uint16_t a = (op.flags & OPF_IMM_A) ? op.a : p.regs[op.a];
+        uint16_t b = (op.flags & OPF_IMM_B) ? op.b : p.regs[op.b];
+        p.regs[op.dst] = a + b;
         break;
     }
 
-    case SUBTRACT: {
-        uint16_t a = inst.isVar2 ? p.vars[inst.var2] : inst.value2;
-        uint16_t b = inst.isVar3 ? p.vars[inst.var3] : inst.value3;
-        p.vars[inst.var1] = a - b;
+    case OP_SUBTRACT: {
+        uint16_t a = (op.flags & OPF_IMM_A) ? op.a : p.regs[op.a];
+        uint16_t b = (op.flags & OPF_IMM_B) ? op.b : p.regs[op.b];
+        p.regs[op.dst] = a - b;
         break;
     }
 
-    case SLEEP:
-        p.sleep_ticks = inst.sleepTicks;
-        return;
+    case OP_SLEEP:
+        // The CPU worker counts the ticks down and then advances pc
+        if (op.a > 0) {
+            p.sleep_ticks = op.a;
+            return;
+        }
+        break;
 
-    case FOR_LOOP: {
-        for (int i = 0; i < inst.repeatCount; i++) {
-            for (auto& nested : inst.nestedInstructions) {
-                execute(p, nested);
-                if (p.finished) return;
-            }
+    case OP_LOOP:
+        if (op.a == 0) {
+            next_pc = p.pc + op.b;
+        }
+        else {
+            p.loop_counters[op.dst] = op.a;
+        }
+        break;
+
+    case OP_ENDLOOP:
+        if (--p.loop_counters[op.dst] > 0) {
+            next_pc = p.pc - op.a;
         }
         break;
-    }
 
-    case READ: {
+    case OP_READ: {
         uint16_t value = 0;
-        if (mm.readMemory(p.pid, inst.memory_address, value)) {
-            p.vars[inst.var] = value;
-            p.screenBuffer.push_back("(" + Utils::getTimestamp() + ") READ " +
-                inst.var + " from address " +
-                std::to_string(inst.memory_address) +
-                " = " + std::to_string(value));
+        if (mm.readMemory(p.pid, op.a, value, p.cpu_core)) {
+            p.regs[op.dst] = value;
+            p.log.push(LOG_READ, op.dst, op.a, value);
         }
         else {
-            p.screenBuffer.push_back("(" + Utils::getTimestamp() + ") ERROR: Failed to read from address " +
-                std::to_string(inst.memory_address));
+            p.log.push(LOG_READ_ERROR, 0, op.a);
         }
         break;
     }
 
-    case WRITE: {
-        if (mm.writeMemory(p.pid, inst.memory_address, inst.write_value)) {
-            p.screenBuffer.push_back("(" + Utils::getTimestamp() + ") WRITE " +
-                std::to_string(inst.write_value) +
-                " to address " +
-                std::to_string(inst.memory_address));
+    case OP_WRITE:
+        if (mm.writeMemory(p.pid, op.a, op.b, p.cpu_core)) {
+            p.log.push(LOG_WRITE, 0, op.a, op.b);
         }
         else {
-            p.screenBuffer.push_back("(" + Utils::getTimestamp() + ") ERROR: Failed to write to address " +
-                std::to_string(inst.memory_address));
+            p.log.push(LOG_WRITE_ERROR, 0, op.a);
         }
         break;
     }
+
+    p.pc = next_pc;
+    p.executed++;
+    if (p.pc >= p.total_instructions) {
+        p.finish();
     }
+}
+
+std::string InstructionExecutor::formatLog(const LogEvent& event, const std::string& process_name,
+    const std::vector<std::string>* symbols) {
+    std::chrono::system_clock::time_point time{ std::chrono::system_clock::duration(event.timestamp) };
+    std::string var = (symbols && event.slot < symbols->size()) ? (*symbols)[event.slot] : "?";
+    std::string line = "(" + Utils::formatTimestamp(time) + ") ";
 
-    p.pc++;
-    if (p.pc >= (int)p.instructions.size()) {
-        p.finished = true;
-        p.end_time = std::chrono::system_clock::now();
+    switch (event.kind) {
+    case LOG_PRINT:
+        return line + "Hello world from " + process_name + "!";
+    case LOG_PRINT_VALUE:
+        return line + "Hello world from " + process_name + "! Value: " + std::to_string(event.value);
+    case LOG_READ:
+        return line + "READ " + var + " from address " + std::to_string(event.address) +
+            " = " + std::to_string(event.value);
+    case LOG_WRITE:
+        return line + "WRITE " + std::to_string(event.value) + " to address " +
+            std::to_string(event.address);
+    case LOG_READ_ERROR:
+        return line + "ERROR: Failed to read from address " + std::to_string(event.address);
+    case LOG_WRITE_ERROR:
+        return line + "ERROR: Failed to write to address " + std::to_string(event.address);
     }
+    return line;
+}
+
+// ============ LogRing Implementation ============
+void LogRing::push(uint8_t kind, uint8_t slot, uint16_t address, uint16_t value) {
+    LogEvent event;
+    event.timestamp = std::chrono::system_clock::now().time_since_epoch().count();
+    event.kind = kind;
+    event.slot = slot;
+    event.address = address;
+    event.value = value;
+
+    if (events.size() < kCapacity) {
+        events.push_back(event);
+    }
+    else {
+        events[total % kCapacity] = event;
+    }
+    total++;
+}
+
+const LogEvent& LogRing::at(int i) const {
+    if ((int)events.size() < kCapacity) return events[i];
+    return events[(total + i) % kCapacity];
+}
+
+// ============ Status Publishing ============
+void StatusSeqlock::publish(const ProcessStatus& status, const LogRing& log) {
+    uint32_t seq = sequence.load(std::memory_order_relaxed);
+    sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    pc.store(status.pc, std::memory_order_relaxed);
+    executed.store(status.executed, std::memory_order_relaxed);
+    cpu_core.store(status.cpu_core, std::memory_order_relaxed);
+    sleep_ticks.store(status.sleep_ticks, std::memory_order_relaxed);
+    expanded_length.store(status.expanded_length, std::memory_order_relaxed);
+    finished.store(status.finished, std::memory_order_relaxed);
+    start_time.store(status.start_time.time_since_epoch().count(), std::memory_order_relaxed);
+    end_time.store(status.end_time.time_since_epoch().count(), std::memory_order_relaxed);
+
+    uint64_t total = log.count();
+    uint64_t oldest = total - log.size();
+    uint64_t from = std::max(log_total.load(std::memory_order_relaxed), total > kLogTail ? total - kLogTail : 0);
+    for (uint64_t n = std::max(from, oldest); n < total; n++) {
+        const LogEvent& event = log.at((int)(n - oldest));
+        log_times[n % kLogTail].store(event.timestamp, std::memory_order_relaxed);
+        log_events[n % kLogTail].store(event.kind | (uint64_t)event.slot << 8
+            | (uint64_t)event.address << 16 | (uint64_t)event.value << 32, std::memory_order_relaxed);
+    }
+    log_total.store(total, std::memory_order_relaxed);
+
+    sequence.store(seq + 2, std::memory_order_release);
+}
+
+ProcessStatus StatusSeqlock::read(LogEvent* log_tail, int* log_count) const {
+    ProcessStatus status;
+    while (true) {
+        uint32_t seq = sequence.load(std::memory_order_acquire);
+        if (seq & 1) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        status.pc = pc.load(std::memory_order_relaxed);
+        status.executed = executed.load(std::memory_order_relaxed);
+        status.cpu_core = cpu_core.load(std::memory_order_relaxed);
+        status.sleep_ticks = sleep_ticks.load(std::memory_order_relaxed);
+        status.expanded_length = expanded_length.load(std::memory_order_relaxed);
+        status.finished = finished.load(std::memory_order_relaxed);
+        status.start_time = std::chrono::system_clock::time_point(
+            std::chrono::system_clock::duration(start_time.load(std::memory_order_relaxed)));
+        status.end_time = std::chrono::system_clock::time_point(
+            std::chrono::system_clock::duration(end_time.load(std::memory_order_relaxed)));
+
+        if (log_tail) {
+            uint64_t total = log_total.load(std::memory_order_relaxed);
+            uint64_t first = total > kLogTail ? total - kLogTail : 0;
+            *log_count = (int)(total - first);
+            for (uint64_t n = first; n < total; n++) {
+                LogEvent& event = log_tail[n - first];
+                uint64_t packed = log_events[n % kLogTail].load(std::memory_order_relaxed);
+                event.timestamp = log_times[n % kLogTail].load(std::memory_order_relaxed);
+                event.kind = (uint8_t)packed;
+                event.slot = (uint8_t)(packed >> 8);
+                event.address = (uint16_t)(packed >> 16);
+                event.value = (uint16_t)(packed >> 32);
+            }
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence.load(std::memory_order_relaxed) == seq) return status;
+    }
+}
+
+void PCB::publishStatus() {
+    ProcessStatus snapshot;
+    snapshot.pc = pc;
+    snapshot.executed = executed;
+    snapshot.cpu_core = cpu_core;
+    snapshot.sleep_ticks = sleep_ticks;
+    snapshot.expanded_length = expanded_length;
+    snapshot.finished = finished;
+    snapshot.start_time = start_time;
+    snapshot.end_time = end_time;
+    status.publish(snapshot, log);
+}
+
+void PCB::finish() {
+    finished = true;
+    end_time = std::chrono::system_clock::now();
+    std::vector<Op>().swap(code);
 }
 
 // ============ ProcessManager Implementation ============
@@ -359,42 +769,299 @@ ProcessManager& ProcessManager::getInstance() {
     return instance;
 }
 
-void ProcessManager::addProcess(PCB* process) {
-    std::lock_guard<std::mutex> lock(process_map_mutex);
-    all_processes[process->name] = process;
-    pid_to_process[process->pid] = process;
+// Epochs: a reader registers under the current epoch's parity. The epoch
+// only advances when the previous one has no readers left, so anything
+// unlinked in epoch e is unreachable once the epoch reaches e + 2.
+ProcessManager::ReadGuard::ReadGuard(ProcessManager& pm) : pm(pm) {
+    while (true) {
+        epoch = pm.epoch.load();
+        pm.readers[epoch & 1]++;
+        if (pm.epoch.load() == epoch) break;
+        pm.readers[epoch & 1]--;
+    }
 }
 
-PCB* ProcessManager::getProcess(const std::string& name) {
-    std::lock_guard<std::mutex> lock(process_map_mutex);
-    auto it = all_processes.find(name);
-    return (it != all_processes.end()) ? it->second : nullptr;
+ProcessManager::ReadGuard::~ReadGuard() {
+    pm.readers[epoch & 1]--;
+}
+
+void ProcessManager::deferFree(std::function<void()> release) {
+    garbage.emplace_back(epoch.load(), std::move(release));
 }
 
-PCB* ProcessManager::getProcess(int pid) {
+void ProcessManager::reclaim() {
+    uint64_t current = epoch.load();
+    if (readers[(current + 1) & 1] == 0) {
+        epoch.store(++current);
+    }
+
+    size_t kept = 0;
+    for (size_t i = 0; i < garbage.size(); i++) {
+        if (garbage[i].first + 2 <= current) garbage[i].second();
+        else if (kept++ != i) garbage[kept - 1] = std::move(garbage[i]);
+    }
+    garbage.resize(kept);
+}
+
+ProcessSlot* ProcessManager::findSlot(uint64_t slot) const {
+    ProcessDirectory* dir = directory.load(std::memory_order_acquire);
+    if (!dir || slot >= published.load(std::memory_order_acquire)) return nullptr;
+
+    uint64_t chunk = slot / kProcessChunk;
+    if (chunk < dir->first_chunk || chunk - dir->first_chunk >= dir->capacity) return nullptr;
+    ProcessChunk* c = dir->chunks[chunk - dir->first_chunk].load(std::memory_order_acquire);
+    return c ? &c->slots[slot % kProcessChunk] : nullptr;
+}
+
+ProcessSlot& ProcessManager::appendSlot() {
+    uint64_t slot = published.load();
+    uint64_t chunk = slot / kProcessChunk;
+    ProcessDirectory* dir = directory.load();
+
+    if (!dir || chunk - dir->first_chunk >= dir->capacity) {
+        // Full: publish a larger directory without the freed leading chunks
+        uint64_t first = chunk;
+        if (dir) {
+            for (uint64_t c = dir->first_chunk; c < chunk; c++) {
+                if (dir->chunks[c - dir->first_chunk].load()) { first = c; break; }
+            }
+        }
+
+        auto grown = new ProcessDirectory();
+        grown->first_chunk = first;
+        grown->capacity = std::max<size_t>(4, (chunk - first + 1) * 2);
+        grown->chunks.reset(new std::atomic<ProcessChunk*>[grown->capacity]);
+        for (size_t i = 0; i < grown->capacity; i++) {
+            ProcessChunk* c = (dir && first + i < chunk) ? dir->chunks[first + i - dir->first_chunk].load() : nullptr;
+            grown->chunks[i].store(c);
+        }
+
+        directory.store(grown, std::memory_order_release);
+        if (dir) deferFree([dir]() { delete dir; });
+        dir = grown;
+    }
+
+    std::atomic<ProcessChunk*>& entry = dir->chunks[chunk - dir->first_chunk];
+    if (!entry.load()) entry.store(new ProcessChunk(), std::memory_order_release);
+    return entry.load()->slots[slot % kProcessChunk];
+}
+
+void ProcessManager::addProcess(PCB* process) {
     std::lock_guard<std::mutex> lock(process_map_mutex);
-    auto it = pid_to_process.find(pid);
-    return (it != pid_to_process.end()) ? it->second : nullptr;
+
+    process->publishStatus();
+    process->table_slot = published.load();
+    ProcessSlot& slot = appendSlot();
+    slot.pcb.store(process, std::memory_order_relaxed);
+    published.store(process->table_slot + 1, std::memory_order_release);
+    setLiveBit(process->table_slot, true);
+
+    name_index[process->name] = process->table_slot;
+    pid_index[process->pid] = process->table_slot;
+    live_count++;
+    reclaim();
 }
 
 bool ProcessManager::processExists(const std::string& name) {
     std::lock_guard<std::mutex> lock(process_map_mutex);
-    return all_processes.find(name) != all_processes.end();
+    return name_index.find(name) != name_index.end();
 }
 
-std::unordered_map<std::string, PCB*> ProcessManager::getAllProcesses() {
+void ProcessManager::summarize(const PCB& process, ProcessRecord& record, bool with_log) {
+    // Identity fields are fixed before the process is registered
+    record.pid = process.pid;
+    record.name = process.name;
+    record.total_instructions = process.total_instructions;
+    record.memory_size = process.memory_size;
+    record.symbols = process.symbols;
+    record.state = (ProcessState)process.state.load(std::memory_order_relaxed);
+
+    record.log_count = 0;
+    ProcessStatus status = with_log ? process.status.read(record.log_tail, &record.log_count)
+        : process.status.read();
+    record.finished = status.finished;
+    record.pc = status.pc;
+    record.executed = status.executed;
+    record.cpu_core = status.cpu_core;
+    record.sleep_ticks = status.sleep_ticks;
+    record.expanded_length = status.expanded_length;
+    record.start_time = status.start_time;
+    record.end_time = status.end_time;
+}
+
+void ProcessManager::retireProcess(PCB* process) {
     std::lock_guard<std::mutex> lock(process_map_mutex);
-    return all_processes;
+
+    ProcessSlot* slot = findSlot(process->table_slot);
+    if (slot) {
+        // State first: a reader that then finds the PCB gone sees the record
+        summarize(*process, slot->record, true);
+        slot->record.metrics = process->metrics;
+        setLiveBit(process->table_slot, false);
+        slot->state.store(SLOT_RETIRED, std::memory_order_release);
+        slot->pcb.store(nullptr, std::memory_order_release);
+        history.push_back(process->table_slot);
+    }
+    live_count--;
+    retired_count++;
+
+    size_t limit = Config::getInstance().getProcessHistory();
+    while (limit > 0 && history.size() > limit) {
+        dropSlot(history.front());
+        history.pop_front();
+    }
+
+    deferFree([process]() { delete process; });
+    reclaim();
+}
+
+void ProcessManager::setLiveBit(uint64_t slot, bool live) {
+    ProcessDirectory* dir = directory.load();
+    ProcessChunk* chunk = dir->chunks[slot / kProcessChunk - dir->first_chunk].load();
+    uint64_t bit = 1ULL << (slot % 64);
+    std::atomic<uint64_t>& word = chunk->live[slot % kProcessChunk / 64];
+    if (live) word.fetch_or(bit, std::memory_order_release);
+    else word.fetch_and(~bit, std::memory_order_release);
+}
+
+void ProcessManager::dropSlot(uint64_t slot) {
+    ProcessSlot* s = findSlot(slot);
+    if (!s) return;
+
+    auto by_name = name_index.find(s->record.name);
+    if (by_name != name_index.end() && by_name->second == slot) name_index.erase(by_name);
+    auto by_pid = pid_index.find(s->record.pid);
+    if (by_pid != pid_index.end() && by_pid->second == slot) pid_index.erase(by_pid);
+    s->state.store(SLOT_DROPPED, std::memory_order_release);
+    dropped_count++;
+
+    ProcessDirectory* dir = directory.load();
+    std::atomic<ProcessChunk*>& entry = dir->chunks[slot / kProcessChunk - dir->first_chunk];
+    ProcessChunk* chunk = entry.load();
+    if (++chunk->dropped == kProcessChunk) {
+        entry.store(nullptr, std::memory_order_release);
+        deferFree([chunk]() { delete chunk; });
+    }
+}
+
+bool ProcessManager::readSlot(uint64_t slot, ProcessRecord& record) {
+    ProcessSlot* s = findSlot(slot);
+    if (!s) return false;
+
+    uint8_t state = s->state.load(std::memory_order_acquire);
+    if (state == SLOT_LIVE) {
+        PCB* process = s->pcb.load(std::memory_order_acquire);
+        if (process) {
+            summarize(*process, record, true);
+            return true;
+        }
+        state = s->state.load(std::memory_order_acquire);  // Retired meanwhile
+    }
+    if (state != SLOT_RETIRED) return false;
+    record = s->record;
+    return true;
+}
+
+bool ProcessManager::findRecord(const std::string& name, ProcessRecord& record) {
+    uint64_t slot;
+    {
+        std::lock_guard<std::mutex> lock(process_map_mutex);
+        auto it = name_index.find(name);
+        if (it == name_index.end()) return false;
+        slot = it->second;
+    }
+
+    ReadGuard guard(*this);
+    return readSlot(slot, record);
+}
+
+bool ProcessManager::findRecord(int pid, ProcessRecord& record) {
+    uint64_t slot;
+    {
+        std::lock_guard<std::mutex> lock(process_map_mutex);
+        auto it = pid_index.find(pid);
+        if (it == pid_index.end()) return false;
+        slot = it->second;
+    }
+
+    ReadGuard guard(*this);
+    return readSlot(slot, record);
+}
+
+void ProcessManager::forEachRecord(const std::function<bool(const ProcessRecord&)>& visit, bool live_only) {
+    ReadGuard guard(*this);
+
+    uint64_t end = published.load(std::memory_order_acquire);
+    ProcessDirectory* dir = directory.load(std::memory_order_acquire);
+    if (!dir) return;
+
+    ProcessRecord live;
+    auto visitSlot = [&](ProcessSlot& s) {
+        uint8_t state = s.state.load(std::memory_order_acquire);
+        if (state == SLOT_LIVE) {
+            PCB* process = s.pcb.load(std::memory_order_acquire);
+            if (process) {
+                summarize(*process, live, false);
+                return visit(live);
+            }
+            state = s.state.load(std::memory_order_acquire);
+        }
+        return state != SLOT_RETIRED || live_only || visit(s.record);
+    };
+
+    for (uint64_t slot = dir->first_chunk * kProcessChunk; slot < end; slot++) {
+        uint64_t chunk = slot / kProcessChunk - dir->first_chunk;
+        if (chunk >= dir->capacity) break;
+        ProcessChunk* c = dir->chunks[chunk].load(std::memory_order_acquire);
+        if (!c) {
+            slot += kProcessChunk - 1 - slot % kProcessChunk;  // Whole chunk dropped
+            continue;
+        }
+
+        if (live_only) {
+            // Slots are chunk-aligned here; walk the set bits only
+            for (int w = 0; w < kProcessChunk / 64; w++) {
+                uint64_t bits = c->live[w].load(std::memory_order_acquire);
+                for (int b = 0; bits != 0; b++, bits >>= 1) {
+                    uint64_t index = slot + w * 64 + b;
+                    if ((bits & 1) && index < end && !visitSlot(c->slots[index % kProcessChunk])) return;
+                }
+            }
+            slot += kProcessChunk - 1;
+            continue;
+        }
+
+        if (!visitSlot(c->slots[slot % kProcessChunk])) return;
+    }
 }
 
 void ProcessManager::cleanup() {
     MemoryManager& mm = MemoryManager::getInstance();
     std::lock_guard<std::mutex> lock(process_map_mutex);
 
-    for (auto& pair : all_processes) {
-        mm.deallocateMemory(pair.second->pid);
-        delete pair.second;
+    ProcessDirectory* dir = directory.exchange(nullptr);
+    if (dir) {
+        for (size_t i = 0; i < dir->capacity; i++) {
+            ProcessChunk* chunk = dir->chunks[i].load();
+            if (!chunk) continue;
+            for (ProcessSlot& slot : chunk->slots) {
+                PCB* process = slot.pcb.load();
+                if (process) {
+                    mm.deallocateMemory(process->pid);
+                    delete process;
+                }
+            }
+            delete chunk;
+        }
+        delete dir;
     }
-    all_processes.clear();
-    pid_to_process.clear();
+
+    for (auto& item : garbage) item.second();
+    garbage.clear();
+    published = 0;
+    live_count = 0;
+    dropped_count.store(retired_count.load());
+    name_index.clear();
+    pid_index.clear();
+    history.clear();
 }
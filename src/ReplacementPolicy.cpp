@@ -0,0 +1,121 @@
+#include "../include/ReplacementPolicy.h"
+#include <algorithm>
+
+// ============ FrameList ============
+void FrameList::reset(int total_frames) {
+    links.assign(total_frames, Link());
+    list_head = list_tail = -1;
+}
+
+void FrameList::pushBack(int frame_id) {
+    Link& link = links[frame_id];
+    if (link.linked) return;
+    link.prev = list_tail;
+    link.next = -1;
+    link.linked = true;
+    if (list_tail != -1) links[list_tail].next = frame_id;
+    else list_head = frame_id;
+    list_tail = frame_id;
+}
+
+void FrameList::unlink(int frame_id) {
+    Link& link = links[frame_id];
+    if (!link.linked) return;
+    if (link.prev != -1) links[link.prev].next = link.next;
+    else list_head = link.next;
+    if (link.next != -1) links[link.next].prev = link.prev;
+    else list_tail = link.prev;
+    link = Link();
+}
+
+void FrameList::moveToBack(int frame_id) {
+    if (list_tail == frame_id || !links[frame_id].linked) return;
+    unlink(frame_id);
+    pushBack(frame_id);
+}
+
+// ============ FIFO / LRU ============
+int FIFOReplacement::selectVictim(std::atomic<bool>*, const std::function<bool(int)>& claim, long long& scanned) {
+    for (int frame_id = list.head(); frame_id != -1; frame_id = list.next(frame_id)) {
+        scanned++;
+        if (claim(frame_id)) return frame_id;
+    }
+    return -1;
+}
+
+// ============ CLOCK ============
+void ClockReplacement::reset(int total_frames) {
+    resident.assign(total_frames, false);
+    hand = 0;
+}
+
+int ClockReplacement::selectVictim(std::atomic<bool>* accessed, const std::function<bool(int)>& claim, long long& scanned) {
+    int total_frames = (int)resident.size();
+
+    // Two sweeps: the first may only be clearing accessed bits
+    for (int step = 0; step < 2 * total_frames; step++) {
+        int frame_id = hand;
+        hand = (hand + 1) % total_frames;
+        if (!resident[frame_id]) continue;
+
+        scanned++;
+        if (accessed[frame_id].exchange(false, std::memory_order_relaxed)) continue;
+        if (claim(frame_id)) return frame_id;
+    }
+    return -1;
+}
+
+// ============ WSClock ============
+void WSClockReplacement::reset(int total_frames) {
+    ClockReplacement::reset(total_frames);
+    last_use.assign(total_frames, 0);
+    now = 0;
+    window = std::max(1, total_frames);
+}
+
+void WSClockReplacement::pageLoaded(int frame_id) {
+    ClockReplacement::pageLoaded(frame_id);
+    last_use[frame_id] = ++now;
+}
+
+int WSClockReplacement::selectVictim(std::atomic<bool>* accessed, const std::function<bool(int)>& claim, long long& scanned) {
+    int total_frames = (int)resident.size();
+    int stalest = -1;
+
+    for (int step = 0; step < total_frames; step++) {
+        int frame_id = hand;
+        hand = (hand + 1) % total_frames;
+        if (!resident[frame_id]) continue;
+
+        scanned++;
+        if (accessed[frame_id].exchange(false, std::memory_order_relaxed)) {
+            last_use[frame_id] = now;
+            continue;
+        }
+        if (now - last_use[frame_id] > window) {
+            if (claim(frame_id)) return frame_id;
+        }
+        else if (stalest == -1 || last_use[frame_id] < last_use[stalest]) {
+            stalest = frame_id;
+        }
+    }
+
+    if (stalest != -1 && claim(stalest)) return stalest;
+
+    // The stalest frame's owner is busy: take anything claimable
+    for (int frame_id = 0; frame_id < total_frames; frame_id++) {
+        if (resident[frame_id] && frame_id != stalest) {
+            scanned++;
+            if (claim(frame_id)) return frame_id;
+        }
+    }
+    return -1;
+}
+
+std::unique_ptr<ReplacementPolicy> makeReplacementPolicy(const std::string& name) {
+    if (name == "fifo") return std::make_unique<FIFOReplacement>();
+    if (name == "lru") return std::make_unique<LRUReplacement>();
+    if (name == "clock") return std::make_unique<ClockReplacement>();
+    if (name == "wsclock") return std::make_unique<WSClockReplacement>();
+    return nullptr;
+}
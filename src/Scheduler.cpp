@@ -3,12 +3,17 @@
 #include "../include/Config.h"
 #include "../include/MemoryManager.h"
 #include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <iomanip>
 #include <sstream>
 #include <thread>
 #include <fstream>
 
+static long long steadyNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
 
 // ============ Scheduler Implementation ============
 Scheduler& Scheduler::getInstance() {
@@ -25,8 +30,18 @@ bool Scheduler::start() {
     Config& config = Config::getInstance();
     int num_cpu = config.getNumCPU();
 
-    cpu_busy.resize(num_cpu, false);
+    if (num_cores != num_cpu) {
+        core_process.reset(new std::atomic<int>[num_cpu]);
+        core_parked_since.reset(new std::atomic<long long>[num_cpu]);
+        num_cores = num_cpu;
+    }
+    for (int i = 0; i < num_cores; i++) {
+        core_process[i] = -1;
+        core_parked_since[i] = 0;
+    }
+    cores_busy = 0;
     cpu_process_count.resize(num_cpu, 0);
+    buildRunQueues(num_cpu, config.getScheduler());
 
     scheduler_running = true;
 
@@ -48,6 +63,10 @@ bool Scheduler::stop() {
 
     std::cout << "Stopping scheduler...\n";
     scheduler_running = false;
+    {
+        std::lock_guard<std::mutex> lock(idle_mutex);
+        idle_cv.notify_all();
+    }
 
     if (process_generator_thread.joinable()) {
         process_generator_thread.join();
@@ -60,32 +79,162 @@ bool Scheduler::stop() {
     }
     cpu_threads.clear();
 
-    {
-        std::lock_guard<std::mutex> lock(cpu_stats_mutex);
-        std::fill(cpu_busy.begin(), cpu_busy.end(), false);
-    }
+    for (int i = 0; i < num_cores; i++) core_process[i] = -1;
+    cores_busy = 0;
 
     std::cout << "Scheduler stopped.\n";
     return true;
 }
 
+// Only called while no CPU workers are running (start, or before the first
+// start). Processes already queued are redistributed over the new queues.
+void Scheduler::buildRunQueues(int num_queues, const std::string& policy_name) {
+    Config& config = Config::getInstance();
+    num_queues = std::max(1, num_queues);
+
+    std::string name = policy_name;
+    if (!makeSchedulingPolicy(name, config.getQuantumCycles())) {
+        std::cout << "ERROR: Unknown scheduler \"" << name << "\", using rr.\n";
+        name = "rr";
+    }
+
+    if ((int)run_queues.size() == num_queues && run_queues[0]->policy->name() == name
+        && run_queue_quantum == config.getQuantumCycles()) return;
+
+    std::vector<PCB*> pending;
+    for (auto& rq : run_queues) {
+        while (PCB* process = rq->policy->pop()) {
+            pending.push_back(process);
+        }
+    }
+
+    run_queues.clear();
+    for (int i = 0; i < num_queues; i++) {
+        run_queues.push_back(std::make_unique<RunQueue>());
+        run_queues.back()->policy = makeSchedulingPolicy(name, config.getQuantumCycles());
+    }
+    run_queue_quantum = config.getQuantumCycles();
+
+    for (size_t i = 0; i < pending.size(); i++) {
+        pushRunQueue(i % num_queues, pending[i]);
+    }
+}
+
+void Scheduler::pushRunQueue(int id, PCB* process, bool requeue) {
+    RunQueue& rq = *run_queues[id];
+    if (process->metrics.ready_since_ns == 0) process->metrics.ready_since_ns = steadyNanos();
+    int queued;
+    {
+        std::lock_guard<std::mutex> lock(rq.mutex);
+        rq.policy->push(process);
+        queued = ++rq.size;
+    }
+
+    // A core requeueing its own preempted process takes it straight back
+    // unless others wait too. Anything else may sit behind a busy owner, so
+    // a parked core is woken to take it.
+    if (!requeue || queued > 1) wakeIdleCore();
+}
+
+// A new process arrives
 void Scheduler::enqueueProcess(PCB* process) {
-    std::lock_guard<std::mutex> lock(ready_queue_mutex);
-    ready_queue.push(process);
+    state_counts[STATE_NEW]++;
+    process->metrics.arrival_ns = steadyNanos();
+    placeProcess(process);
+}
+
+void Scheduler::placeProcess(PCB* process) {
+    if (run_queues.empty()) {
+        // screen -s / screen -c before the first scheduler-start
+        Config& config = Config::getInstance();
+        buildRunQueues(config.getNumCPU(), config.getScheduler());
+    }
+
+    // Spread arrivals: take the next core round-robin, but prefer its
+    // neighbour if that one is parked or has a shorter queue.
+    int n = run_queues.size();
+    int first = next_run_queue.fetch_add(1, std::memory_order_relaxed) % n;
+    int second = (first + 1) % n;
+    auto parked = [this](int id) { return id < num_cores && core_parked_since[id] != 0; };
+    int target = first;
+    if (!parked(first) && (parked(second) || run_queues[second]->size.load(std::memory_order_relaxed) <
+        run_queues[first]->size.load(std::memory_order_relaxed))) target = second;
+
+    setState(process, STATE_READY);
+    pushRunQueue(target, process);
+}
+
+PCB* Scheduler::dequeueProcess(int id) {
+    RunQueue& rq = *run_queues[id];
+    {
+        std::lock_guard<std::mutex> lock(rq.mutex);
+        if (PCB* process = rq.policy->pop()) {
+            rq.size--;
+            return process;
+        }
+    }
+    return stealProcess(id);
 }
 
-int Scheduler::getCoresUsed() {
-    std::lock_guard<std::mutex> lock(cpu_stats_mutex);
+// Take the policy's next process from the first busy core found, starting
+// at our right-hand neighbour. Contended queues are skipped at first and
+// only waited on if no other queue had work, so a woken core that lost
+// every try_lock does not go back to spinning on hasQueuedWork.
+PCB* Scheduler::stealProcess(int thief) {
+    int n = run_queues.size();
+    for (int pass = 0; pass < 2; pass++) {
+        bool contended = false;
+        for (int i = 1; i < n; i++) {
+            RunQueue& victim = *run_queues[(thief + i) % n];
+            if (victim.size.load(std::memory_order_relaxed) == 0) continue;
+
+            std::unique_lock<std::mutex> lock(victim.mutex, std::defer_lock);
+            if (pass == 0 && !lock.try_lock()) {
+                contended = true;
+                continue;
+            }
+            if (pass == 1) lock.lock();
+
+            if (PCB* process = victim.policy->pop()) {
+                victim.size--;
+                return process;
+            }
+        }
+        if (!contended) break;
+    }
+    return nullptr;
+}
+
+std::string Scheduler::getPolicyName() {
+    if (run_queues.empty()) return Config::getInstance().getScheduler();
+    return run_queues[0]->policy->name();
+}
+
+std::vector<bool> Scheduler::getCPUBusy() {
+    std::vector<bool> busy(num_cores);
+    for (int i = 0; i < num_cores; i++) busy[i] = core_process[i] != -1;
+    return busy;
+}
+
+int Scheduler::getUnfinishedCount() const {
     int count = 0;
-    for (bool busy : cpu_busy) {
-        if (busy) count++;
+    for (int state = STATE_NEW; state < STATE_FINISHED; state++) {
+        count += state_counts[state];
     }
     return count;
 }
 
-std::vector<bool> Scheduler::getCPUBusy() {
-    std::lock_guard<std::mutex> lock(cpu_stats_mutex);
-    return cpu_busy;
+void Scheduler::setState(PCB* process, ProcessState state) {
+    ProcessState previous = (ProcessState)process->state.exchange(state);
+    if (previous == state) return;
+    state_counts[previous]--;
+    state_counts[state]++;
+}
+
+void Scheduler::setCoreProcess(int id, int pid) {
+    int previous = core_process[id].exchange(pid);
+    if (previous == -1 && pid != -1) cores_busy++;
+    else if (previous != -1 && pid == -1) cores_busy--;
 }
 
 void Scheduler::cpuWorker(int id) {
@@ -93,101 +242,385 @@ void Scheduler::cpuWorker(int id) {
     MemoryManager& mm = MemoryManager::getInstance();
     PCB* current_process = nullptr;
     int current_run_cycles = 0;
+    int current_time_slice = 0;
+    int current_run_ticks = 0;
+    auto dispatch_time = std::chrono::steady_clock::now();
+    auto io_clock = dispatch_time; // Fault countdown credited up to here
+    uint64_t loaded_slot = UINT64_MAX; // Table slot of the last process this core held
 
     while (scheduler_running) {
-        if (current_process == nullptr) {
-            std::unique_lock<std::mutex> lock(ready_queue_mutex);
-            if (!ready_queue.empty()) {
-                current_process = ready_queue.front();
-                ready_queue.pop();
-                current_run_cycles = 0;
+        // Faults count down in elapsed ticks, busy or idle, so
+        // page-fault-latency is a time and not a loop count
+        if (!run_queues[id]->io_wait.empty()) {
+            long long tick = getTickNanos();
+            long long ticks = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - io_clock).count() / tick;
+            if (ticks > 0) {
+                io_clock += std::chrono::nanoseconds(ticks * tick);
+                tickIoWait(id, ticks);
             }
         }
 
-        // [NEW] Tick counting logic
-        // If we have a process, it's an active tick. If not, it's an idle tick.
-        if (current_process != nullptr) {
-            active_ticks++;
-        }
-        else {
-            // Check if queue is empty to truly confirm idle
-            // (Strictly speaking, if current_process is null here, the core is idle)
-            idle_ticks++;
+        if (current_process == nullptr) {
+            current_process = dequeueProcess(id);
+            current_run_cycles = 0;
+            current_run_ticks = 0;
+            if (current_process) {
+                current_time_slice = run_queues[id]->policy->timeSlice(current_process);
+                setCoreProcess(id, current_process->pid);
+
+                // Queue time only counts as waiting while the process was ready
+                ProcessMetrics& metrics = current_process->metrics;
+                long long now = steadyNanos();
+                if (current_process->state == STATE_READY) metrics.wait_ns += now - metrics.ready_since_ns;
+                metrics.ready_since_ns = 0;
+                if (metrics.response_ns < 0) metrics.response_ns = now - metrics.arrival_ns;
+                if (current_process->table_slot != loaded_slot) {
+                    metrics.context_switches++;
+                    loaded_slot = current_process->table_slot;
+                }
+
+                if (current_process->state != STATE_SLEEPING) setState(current_process, STATE_RUNNING);
+            }
+            dispatch_time = std::chrono::steady_clock::now();
         }
 
-        if (current_process) {
-            bool process_finished_this_run = false;
-            bool process_preempted_this_run = false;
+        // Tick counting logic
+        // If we have a process, it's an active tick. Idle ticks are credited
+        // by waitForWork for the time the core spends parked.
+        if (current_process == nullptr) {
+            setCoreProcess(id, -1);
 
-            {
-                std::lock_guard<std::mutex> lock(cpu_stats_mutex);
-                cpu_busy[id] = true;
+            // Nothing runnable, but a fault is in flight: sleep a tick at a
+            // time to complete it, waking early for new work
+            if (!run_queues[id]->io_wait.empty()) {
+                auto tick = std::chrono::nanoseconds(getTickNanos());
+                auto waited_from = std::chrono::steady_clock::now();
+                {
+                    std::unique_lock<std::mutex> lock(idle_mutex);
+                    idle_cv.wait_for(lock, tick, [this] { return !scheduler_running || hasQueuedWork(); });
+                }
+                iowait_ticks += std::max<long long>(1, (std::chrono::steady_clock::now() - waited_from) / tick);
+                continue;
             }
 
-            {
-                std::lock_guard<std::mutex> pcb_lock(current_process->pcb_mutex);
-                current_process->cpu_core = id;
-
-                if (current_process->sleep_ticks > 0) {
-                    // ... (sleep logic remains same) ...
-                    current_process->sleep_ticks--;
-                    if (current_process->sleep_ticks == 0) {
-                        current_process->pc++;
-                        if (current_process->pc >= (int)current_process->instructions.size()) {
-                            current_process->finished = true;
-                            current_process->end_time = std::chrono::system_clock::now();
-                        }
+            waitForWork(id);
+            continue;
+        }
+
+        active_ticks++;
+        current_run_ticks++;
+
+        bool process_finished_this_run = false;
+        bool process_preempted_this_run = false;
+        bool process_blocked_this_run = false;
+
+        {
+            std::lock_guard<std::mutex> pcb_lock(current_process->pcb_mutex);
+            current_process->cpu_core = id;
+
+            if (current_process->sleep_ticks > 0) {
+                // ... (sleep logic remains same) ...
+                current_process->sleep_ticks--;
+                current_process->metrics.sleep_ticks++;
+                if (current_process->sleep_ticks == 0) {
+                    current_process->pc++;
+                    current_process->executed++;
+                    if (current_process->pc >= current_process->total_instructions) {
+                        current_process->finish();
                     }
-                    process_preempted_this_run = true;
+                }
+                if (current_process->finished) {
+                    process_finished_this_run = true;
                 }
                 else {
-                    if (mm.isInitialized() && current_process->memory_size > 0) {
-                        uint16_t dummy_val = 0;
-                        int fetch_address = current_process->pc % current_process->memory_size;
+                    process_preempted_this_run = true;
+                }
+            }
+            else if (int fault_address = findMissingPage(current_process, id); fault_address != -1) {
+                // Asynchronous fault: the process blocks and the core moves on
+                current_process->io_wait_ticks = config.getPageFaultLatency();
+                current_process->fault_address = fault_address;
+                process_blocked_this_run = true;
+            }
+            else {
+                if (mm.isInitialized() && current_process->memory_size > 0) {
+                    uint16_t dummy_val = 0;
+                    int fetch_address = current_process->pc % current_process->memory_size;
 
-                        // This read will trigger a Page Fault if the page isn't in RAM
-                        mm.readMemory(current_process->pid, fetch_address, dummy_val);
-                    }
+                    // This read will trigger a Page Fault if the page isn't in RAM
+                    mm.readMemory(current_process->pid, fetch_address, dummy_val, id);
+                }
 
-                    // Execute actual logic
-                    InstructionExecutor::execute(*current_process,
-                        current_process->instructions[current_process->pc]);
-                    current_run_cycles++;
+                // Execute actual logic
+                InstructionExecutor::execute(*current_process);
+                current_process->metrics.cpu_ticks++;
+                current_run_cycles++;
 
-                    if (current_process->finished) {
-                        process_finished_this_run = true;
-                    }
-                    else if (current_run_cycles >= config.getQuantumCycles()) {
+                if (current_process->finished) {
+                    process_finished_this_run = true;
+                }
+                else if (current_run_cycles >= current_time_slice) {
+                    RunQueue& rq = *run_queues[id];
+                    std::lock_guard<std::mutex> lock(rq.mutex);
+                    if (rq.policy->sliceExpired(current_process)) {
                         process_preempted_this_run = true;
                     }
+                    else {
+                        current_run_cycles = 0;
+                    }
                 }
             }
 
             if (process_finished_this_run) {
-                {
-                    std::lock_guard<std::mutex> lock(cpu_stats_mutex);
-                    cpu_process_count[id]++;
-                    cpu_busy[id] = false;
-                }
+                setState(current_process, STATE_FINISHED);
+            }
+            else if (process_blocked_this_run) {
+                setState(current_process, STATE_BLOCKED);
+            }
+            else if (process_preempted_this_run) {
+                setState(current_process, current_process->sleep_ticks > 0 ? STATE_SLEEPING : STATE_READY);
+            }
+            current_process->publishStatus();
+        }
 
-                // Deallocate memory when process finishes
-                if (mm.isInitialized() && current_process->memory_size > 0) {
-                    mm.deallocateMemory(current_process->pid);
-                }
+        if (process_finished_this_run) {
+            {
+                std::lock_guard<std::mutex> lock(cpu_stats_mutex);
+                cpu_process_count[id]++;
+            }
+            setCoreProcess(id, -1);
 
-                current_process = nullptr;
+            // Deallocate memory when process finishes
+            if (mm.isInitialized() && current_process->memory_size > 0) {
+                current_process->metrics.page_faults = mm.getPageFaults(current_process->pid);
+                mm.deallocateMemory(current_process->pid);
+                admitPending();
             }
-            else if (process_preempted_this_run) {
-                if (!current_process->finished) {
-                    std::lock_guard<std::mutex> lock(ready_queue_mutex);
-                    ready_queue.push(current_process);
-                }
-                current_process = nullptr;
+
+            ProcessManager::getInstance().retireProcess(current_process);
+            current_process = nullptr;
+        }
+        else if (process_preempted_this_run) {
+            if (!current_process->finished) {
+                pushRunQueue(id, current_process, true);
+            }
+            current_process = nullptr;
+        }
+        else if (process_blocked_this_run) {
+            if (run_queues[id]->io_wait.empty()) io_clock = std::chrono::steady_clock::now();
+            run_queues[id]->io_wait.push_back(current_process);
+            blocking_faults++;
+            current_process = nullptr;
+        }
+
+        if (current_process == nullptr) {
+            recordTickDuration(dispatch_time, current_run_ticks);
+        }
+
+        int delay = config.getDelaysPerExec();
+        if (delay > 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(delay));
+        }
+    }
+
+    // Stopped mid-slice: the process goes back to the queue
+    if (current_process) {
+        setState(current_process, STATE_READY);
+        pushRunQueue(id, current_process);
+    }
+    setCoreProcess(id, -1);
+
+    // Faults still in flight: requeue, the access simply faults again
+    for (PCB* process : run_queues[id]->io_wait) {
+        process->io_wait_ticks = 0;
+        setState(process, STATE_READY);
+        pushRunQueue(id, process);
+    }
+    run_queues[id]->io_wait.clear();
+}
+
+// With page-fault-latency set, returns the first address the next
+// instruction needs (fetch, then READ/WRITE operand) whose page is not
+// resident, or -1. The caller holds the process's pcb_mutex.
+int Scheduler::findMissingPage(PCB* process, int core) {
+    MemoryManager& mm = MemoryManager::getInstance();
+    if (Config::getInstance().getPageFaultLatency() <= 0) return -1;
+    if (!mm.isInitialized() || process->memory_size <= 0) return -1;
+
+    int fetch_address = process->pc % process->memory_size;
+    if (!mm.isResident(process->pid, fetch_address, core)) return fetch_address;
+
+    int operand = InstructionExecutor::memoryOperand(*process);
+    if (operand != -1 && !mm.isResident(process->pid, operand, core)) return operand;
+    return -1;
+}
+
+// Counts down this core's outstanding faults by the ticks elapsed. A
+// completed one loads the page and makes its process ready again.
+void Scheduler::tickIoWait(int id, long long ticks) {
+    MemoryManager& mm = MemoryManager::getInstance();
+    std::vector<PCB*>& io_wait = run_queues[id]->io_wait;
+
+    for (size_t i = 0; i < io_wait.size(); ) {
+        PCB* process = io_wait[i];
+        {
+            std::lock_guard<std::mutex> pcb_lock(process->pcb_mutex);
+            process->io_wait_ticks -= (int)std::min<long long>(ticks, process->io_wait_ticks);
+            if (process->io_wait_ticks > 0) {
+                i++;
+                continue;
             }
         }
 
-        std::this_thread::sleep_for(std::chrono::milliseconds(config.getDelaysPerExec()));
+        mm.pageIn(process->pid, process->fault_address);
+        io_wait[i] = io_wait.back();
+        io_wait.pop_back();
+        setState(process, STATE_READY);
+        pushRunQueue(id, process);
+    }
+}
+
+// Park an idle core until a process is queued anywhere or the scheduler
+// stops. The parked time is converted into idle ticks on wake-up.
+void Scheduler::waitForWork(int id) {
+    auto parked_at = std::chrono::steady_clock::now();
+
+    {
+        std::unique_lock<std::mutex> lock(idle_mutex);
+        core_parked_since[id].store(parked_at.time_since_epoch().count());
+        parked_cores++;
+        idle_cv.wait(lock, [this] { return !scheduler_running || hasQueuedWork(); });
+        parked_cores--;
+        core_parked_since[id].store(0);
+    }
+
+    auto parked = std::chrono::steady_clock::now() - parked_at;
+    idle_ticks += std::max<long long>(1,
+        std::chrono::duration_cast<std::chrono::nanoseconds>(parked).count() / getTickNanos());
+}
+
+bool Scheduler::hasQueuedWork() const {
+    for (const auto& rq : run_queues) {
+        if (rq->size.load() > 0) return true;
+    }
+    return false;
+}
+
+void Scheduler::wakeIdleCore() {
+    if (parked_cores.load() > 0) {
+        std::lock_guard<std::mutex> lock(idle_mutex);
+        idle_cv.notify_one();
+    }
+}
+
+// With delay-per-exec set, one tick is one delay. Without it, a tick is as
+// long as an instruction actually takes, measured per dispatch.
+long long Scheduler::getTickNanos() const {
+    int delay = Config::getInstance().getDelaysPerExec();
+    if (delay > 0) return delay * 1000000LL;
+    return std::max<long long>(1, tick_ns.load(std::memory_order_relaxed));
+}
+
+void Scheduler::recordTickDuration(std::chrono::steady_clock::time_point since, int ticks) {
+    if (ticks <= 0) return;
+    long long elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - since).count();
+    long long sample = elapsed / ticks;
+    long long estimate = tick_ns.load(std::memory_order_relaxed);
+    tick_ns.store(estimate + (sample - estimate) / 8, std::memory_order_relaxed);
+}
+
+unsigned long long Scheduler::getIdleTicks() const {
+    unsigned long long ticks = idle_ticks;
+
+    // Include time cores have been parked so far but not yet credited
+    long long now = std::chrono::steady_clock::now().time_since_epoch().count();
+    long long tick = getTickNanos();
+    for (int i = 0; i < num_cores; i++) {
+        long long since = core_parked_since[i].load();
+        if (since != 0 && now > since) {
+            ticks += (now - since) / tick;
+        }
+    }
+    return ticks;
+}
+
+// memory-overcommit caps the pages committed to processes, plus those
+// being admitted right now, at that many times the physical frames. A
+// process larger than the whole cap is admitted only while nothing else is
+// committed, so it runs alone instead of never. Hold admission_mutex.
+bool Scheduler::fitsCommitLimit(int memory_size) const {
+    MemoryManager& mm = MemoryManager::getInstance();
+    double overcommit = Config::getInstance().getMemoryOvercommit();
+    if (overcommit <= 0 || !mm.isInitialized() || memory_size <= 0) return true;
+
+    long long committed = mm.getCommittedPages() + admitting_pages;
+    long long pages = mm.pagesFor(memory_size);
+    double cap = overcommit * mm.getTotalFrames();
+    if (pages > cap) return committed == 0;
+    return committed + pages <= cap;
+}
+
+// Counts a process's pages against the limit until admit has allocated
+// them. Hold admission_mutex.
+long long Scheduler::reservePages(PCB* process) {
+    MemoryManager& mm = MemoryManager::getInstance();
+    long long pages = (process->memory_size > 0 && mm.isInitialized()) ? mm.pagesFor(process->memory_size) : 0;
+    admitting_pages += pages;
+    return pages;
+}
+
+// Runs without admission_mutex: allocateMemory waits for page_tables_mutex,
+// which a fault holds through a whole eviction, and the generator and
+// finishing cores must not queue up behind that
+bool Scheduler::admit(PCB* process, long long reserved_pages) {
+    MemoryManager& mm = MemoryManager::getInstance();
+    bool allocated = process->memory_size <= 0 || !mm.isInitialized()
+        || mm.allocateMemory(process->pid, process->memory_size);
+    admitting_pages -= reserved_pages;
+    if (!allocated) {
+        std::lock_guard<std::mutex> lock(admission_mutex);
+        pending_admission.push_back(process);
+        return false;
     }
+    placeProcess(process);
+    return true;
+}
+
+void Scheduler::admitOrDefer(PCB* process) {
+    state_counts[STATE_NEW]++;
+    process->metrics.arrival_ns = steadyNanos();
+    long long pages;
+    {
+        std::lock_guard<std::mutex> lock(admission_mutex);
+        if (!pending_admission.empty() || !fitsCommitLimit(process->memory_size)) {
+            pending_admission.push_back(process);
+            return;
+        }
+        pages = reservePages(process);
+    }
+    admit(process, pages);
+}
+
+// Admits waiting processes, oldest first, while they fit
+void Scheduler::admitPending() {
+    std::vector<std::pair<PCB*, long long>> admitted;
+    {
+        std::lock_guard<std::mutex> lock(admission_mutex);
+        while (!pending_admission.empty() && fitsCommitLimit(pending_admission.front()->memory_size)) {
+            admitted.emplace_back(pending_admission.front(), reservePages(pending_admission.front()));
+            pending_admission.pop_front();
+        }
+    }
+    for (auto& entry : admitted) {
+        admit(entry.first, entry.second);
+    }
+}
+
+int Scheduler::getPendingAdmissions() {
+    std::lock_guard<std::mutex> lock(admission_mutex);
+    return (int)pending_admission.size();
 }
 
 void Scheduler::processGeneratorWorker() {
@@ -217,20 +650,11 @@ void Scheduler::processGeneratorWorker() {
             }
         }
 
-        PCB* p = process_generator.createRandomProcess(next_pid++, memory_size);
-
-        // Allocate memory if needed
-        if (memory_size > 0 && mm.isInitialized()) {
-            if (!mm.allocateMemory(p->pid, memory_size)) {
-                // If allocation fails, skip this process
-                delete p;
-                std::this_thread::sleep_for(std::chrono::seconds(config.getBatchProcessFreq()));
-                continue;
-            }
-        }
+        admitPending();
 
+        PCB* p = process_generator.createRandomProcess(next_pid++, memory_size);
         pm.addProcess(p);
-        enqueueProcess(p);
+        admitOrDefer(p);
 
         std::this_thread::sleep_for(std::chrono::seconds(config.getBatchProcessFreq()));
     }
@@ -244,14 +668,14 @@ ScreenManager& ScreenManager::getInstance() {
 
 void ScreenManager::displayProcessScreen(const std::string& process_name) {
     ProcessManager& pm = ProcessManager::getInstance();
-    PCB* p = pm.getProcess(process_name);
+    ProcessRecord record;
 
-    if (!p) {
+    if (!pm.findRecord(process_name, record)) {
         std::cout << "Process '" << process_name << "' not found.\n";
         return;
     }
 
-    std::lock_guard<std::mutex> pcb_lock(p->pcb_mutex);
+    const ProcessRecord* p = &record;
     Utils::clearScreen();
 
     std::cout << "Process: " << p->name << "\n";
@@ -270,9 +694,8 @@ void ScreenManager::displayProcessScreen(const std::string& process_name) {
     }
 
     std::cout << "\n--- Logs ---\n";
-    int start = std::max(0, (int)p->screenBuffer.size() - 20);
-    for (int i = start; i < (int)p->screenBuffer.size(); i++) {
-        std::cout << p->screenBuffer[i] << "\n";
+    for (int i = 0; i < p->log_count; i++) {
+        std::cout << InstructionExecutor::formatLog(p->log_tail[i], p->name, p->symbols.get()) << "\n";
     }
 
     if (p->finished) {
@@ -317,19 +740,22 @@ void ScreenManager::processSMI() {
     std::cout << "--------------------------------------------------\n";
 
     // 3. List Running Processes
-    // We iterate through all processes and print only the ones that are NOT finished
-    auto all_processes = pm.getAllProcesses();
+    // We walk only the live slots and print the ones that are NOT finished,
+    // stopping once the scheduler's count of them has been printed
+    int remaining = scheduler.getUnfinishedCount();
     bool any_running = false;
 
-    for (const auto& pair : all_processes) {
-        PCB* p = pair.second;
-        if (!p->finished) {
+    pm.forEachRecord([&](const ProcessRecord& p) {
+        if (remaining <= 0) return false;
+        if (!p.finished) {
             // Print Process Name and Memory Size
-            std::cout << std::left << std::setw(20) << p->name
-                << p->memory_size << " bytes\n";
+            std::cout << std::left << std::setw(20) << p.name
+                << p.memory_size << " bytes\n";
             any_running = true;
+            remaining--;
         }
-    }
+        return true;
+    }, true);
 
     if (!any_running) {
         std::cout << "No running processes.\n";
@@ -339,7 +765,7 @@ void ScreenManager::processSMI() {
     std::cout << "\n";
 }
 
-void ScreenManager::screenLS() {
+void ScreenManager::screenLS(ListFilter filter, int limit) {
     Config& config = Config::getInstance();
     Scheduler& scheduler = Scheduler::getInstance();
     ProcessManager& pm = ProcessManager::getInstance();
@@ -347,21 +773,26 @@ void ScreenManager::screenLS() {
     int cores_used = scheduler.getCoresUsed();
     int num_cpu = config.getNumCPU();
 
-    int running = 0, finished = 0;
-    std::vector<PCB*> process_list_copy;
-
-    auto all_processes = pm.getAllProcesses();
-    for (const auto& pair : all_processes) {
-        process_list_copy.push_back(pair.second);
-        if (pair.second->finished) finished++;
-        else running++;
-    }
-
-    std::cout << "\nRunning processes: " << running << "\n";
-    std::cout << "Finished processes: " << finished << "\n";
+    std::cout << "\nRunning processes: " << scheduler.getUnfinishedCount() << " ("
+        << scheduler.getStateCount(STATE_RUNNING) << " running, "
+        << scheduler.getStateCount(STATE_READY) << " ready, "
+        << scheduler.getStateCount(STATE_SLEEPING) << " sleeping, "
+        << scheduler.getStateCount(STATE_BLOCKED) << " blocked, "
+        << scheduler.getStateCount(STATE_NEW) << " new)\n";
+    std::cout << "Finished processes: " << scheduler.getStateCount(STATE_FINISHED) << "\n";
     std::cout << "+---------------+--------------------------+----------+-----------------------------------+" << std::endl;
-    for (PCB* p : process_list_copy) {
-        std::lock_guard<std::mutex> pcb_lock(p->pcb_mutex);
+    // A filtered walk stops once the counters say every match was shown
+    long long matching = -1;
+    if (filter == LIST_RUNNING) matching = scheduler.getUnfinishedCount();
+    else if (filter == LIST_FINISHED) matching = (long long)pm.getRecordCount();
+    if (limit > 0 && (matching < 0 || matching > limit)) matching = limit;
+
+    long long shown = 0;
+    pm.forEachRecord([&](const ProcessRecord& record) {
+        const ProcessRecord* p = &record;
+        if (matching >= 0 && shown >= matching) return false;
+        if ((filter == LIST_RUNNING && p->finished) || (filter == LIST_FINISHED && !p->finished)) return true;
+        shown++;
 
         auto time = std::chrono::system_clock::to_time_t(p->start_time);
         std::tm timeinfo;
@@ -384,16 +815,17 @@ void ScreenManager::screenLS() {
         }
 
         int barWidth = 20;
-        int filled = (p->pc * barWidth) / p->total_instructions;
+        int filled = p->expanded_length > 0 ? (int)((long long)p->executed * barWidth / p->expanded_length) : 0;
 
         std::cout << "[";
         for (int i = 0; i < barWidth; i++) {
             if (i < filled) std::cout << "=";
             else std::cout << " ";
         }
-        std::cout << "] " << std::right << std::setw(3) << p->pc << " / "
-            << p->total_instructions << " |\n";
-    }
+        std::cout << "] " << std::right << std::setw(3) << p->executed << " / "
+            << p->expanded_length << " |\n";
+        return true;
+    }, filter == LIST_RUNNING);
     std::cout << "+---------------+--------------------------+----------+-----------------------------------+" << std::endl;
     std::cout << "\nCPU Utilization: " << (cores_used * 100 / num_cpu) << "%\n";
     std::cout << "Cores used: " << cores_used << "\n";
@@ -401,6 +833,22 @@ void ScreenManager::screenLS() {
     std::cout << "+---------------+--------------------------+----------+-----------------------------------+" << std::endl;
 }
 
+// One report-util line: mean, nearest-rank p50 and p99, and max
+static void reportDistribution(std::ostream& out, const std::string& label, std::vector<double>& values) {
+    if (values.empty()) return;
+    std::sort(values.begin(), values.end());
+    double sum = 0;
+    for (double value : values) sum += value;
+    auto rank = [&](double q) { return values[std::min(values.size() - 1, (size_t)std::ceil(q * values.size()) - 1)]; };
+
+    std::ios format(nullptr);
+    format.copyfmt(out);
+    out << std::left << std::setw(20) << label << std::right << std::fixed << std::setprecision(3)
+        << std::setw(12) << sum / values.size() << std::setw(12) << rank(0.50)
+        << std::setw(12) << rank(0.99) << std::setw(12) << values.back() << "\n";
+    out.copyfmt(format);
+}
+
 void ScreenManager::reportUtil() {
     Config& config = Config::getInstance();
     Scheduler& scheduler = Scheduler::getInstance();
@@ -415,20 +863,52 @@ void ScreenManager::reportUtil() {
     int cores_used = scheduler.getCoresUsed();
     int num_cpu = config.getNumCPU();
 
+    // One pass over the table: rows are formatted as they are visited
     int running = 0, finished = 0;
-    std::vector<PCB*> running_processes, finished_processes;
+    std::stringstream running_rows, finished_rows;
+    double total_turnaround = 0.0;
+    auto first_start = std::chrono::system_clock::time_point::max();
+    auto last_end = std::chrono::system_clock::time_point::min();
+    std::vector<double> wait_ms, response_ms, turnaround_ms, cpu_ticks, context_switches, sleep_ticks, page_faults;
+
+    pm.forEachRecord([&](const ProcessRecord& record) {
+        const ProcessRecord* p = &record;
+        auto time = std::chrono::system_clock::to_time_t(p->start_time);
+        std::tm timeinfo;
+#ifdef _WIN32
+        localtime_s(&timeinfo, &time);
+#else
+        localtime_r(&time, &timeinfo);
+#endif
+
+        std::stringstream ss;
+        ss << std::put_time(&timeinfo, "%m/%d/%Y %I:%M:%S%p");
 
-    auto all_processes = pm.getAllProcesses();
-    for (const auto& pair : all_processes) {
-        if (pair.second->finished) {
+        if (p->finished) {
             finished++;
-            finished_processes.push_back(pair.second);
+            total_turnaround += std::chrono::duration<double>(p->end_time - p->start_time).count();
+            first_start = std::min(first_start, p->start_time);
+            last_end = std::max(last_end, p->end_time);
+
+            const ProcessMetrics& m = p->metrics;
+            wait_ms.push_back(m.wait_ns / 1e6);
+            response_ms.push_back(std::max<int64_t>(0, m.response_ns) / 1e6);
+            turnaround_ms.push_back(std::chrono::duration<double, std::milli>(p->end_time - p->start_time).count());
+            cpu_ticks.push_back(m.cpu_ticks);
+            context_switches.push_back(m.context_switches);
+            sleep_ticks.push_back(m.sleep_ticks);
+            page_faults.push_back(m.page_faults);
+
+            finished_rows << p->name << "    (" << ss.str() << ")    Finished    "
+                << p->executed << " / " << p->expanded_length << "\n";
         }
         else {
             running++;
-            running_processes.push_back(pair.second);
+            running_rows << p->name << "    (" << ss.str() << ")    Core: "
+                << p->cpu_core << "    " << p->executed << " / " << p->expanded_length << "\n";
         }
-    }
+        return true;
+    });
 
     report << "CPU Utilization Report\n";
     report << "Generated: " << Utils::getTimestamp() << "\n\n";
@@ -438,43 +918,33 @@ void ScreenManager::reportUtil() {
     report << "Running processes: " << running << "\n";
     report << "Finished processes: " << finished << "\n\n";
 
+    // Policy comparison: average turnaround and throughput over finished processes
+    report << "Scheduler: " << scheduler.getPolicyName() << "\n";
+    if (finished > 0) {
+        double span = std::chrono::duration<double>(last_end - first_start).count();
+        report << "Average turnaround: " << (total_turnaround / finished) << " s\n";
+        report << "Throughput: " << (span > 0 ? finished / span : 0.0) << " processes/s\n";
+
+        report << "\nPer-process metrics (finished processes):\n";
+        report << std::left << std::setw(20) << "" << std::right << std::setw(12) << "mean"
+            << std::setw(12) << "p50" << std::setw(12) << "p99" << std::setw(12) << "max" << "\n";
+        reportDistribution(report, "Wait (ms)", wait_ms);
+        reportDistribution(report, "Response (ms)", response_ms);
+        reportDistribution(report, "Turnaround (ms)", turnaround_ms);
+        reportDistribution(report, "CPU ticks", cpu_ticks);
+        reportDistribution(report, "Context switches", context_switches);
+        reportDistribution(report, "Sleep ticks", sleep_ticks);
+        reportDistribution(report, "Page faults", page_faults);
+    }
+    report << "\n";
+
     report << "--------------------------------------\n";
 
     report << "Running processes:\n";
-    for (PCB* p : running_processes) {
-        std::lock_guard<std::mutex> pcb_lock(p->pcb_mutex);
-        auto time = std::chrono::system_clock::to_time_t(p->start_time);
-        std::tm timeinfo;
-#ifdef _WIN32
-        localtime_s(&timeinfo, &time);
-#else
-        localtime_r(&time, &timeinfo);
-#endif
-
-        std::stringstream ss;
-        ss << std::put_time(&timeinfo, "%m/%d/%Y %I:%M:%S%p");
-
-        report << p->name << "    (" << ss.str() << ")    Core: "
-            << p->cpu_core << "    " << p->pc << " / " << p->total_instructions << "\n";
-    }
+    report << running_rows.str();
 
     report << "\nFinished processes:\n";
-    for (PCB* p : finished_processes) {
-        std::lock_guard<std::mutex> pcb_lock(p->pcb_mutex);
-        auto time = std::chrono::system_clock::to_time_t(p->start_time);
-        std::tm timeinfo;
-#ifdef _WIN32
-        localtime_s(&timeinfo, &time);
-#else
-        localtime_r(&time, &timeinfo);
-#endif
-
-        std::stringstream ss;
-        ss << std::put_time(&timeinfo, "%m/%d/%Y %I:%M:%S%p");
-
-        report << p->name << "    (" << ss.str() << ")    Finished    "
-            << p->pc << " / " << p->total_instructions << "\n";
-    }
+    report << finished_rows.str();
 
     report << "--------------------------------------\n";
 
@@ -0,0 +1,92 @@
+#include "../include/SchedulingPolicy.h"
+#include <algorithm>
+#include <climits>
+
+// ============ FCFS ============
+PCB* FCFSPolicy::pop() {
+    if (queue.empty()) return nullptr;
+    PCB* process = queue.front();
+    queue.pop_front();
+    return process;
+}
+
+int FCFSPolicy::timeSlice(const PCB*) const {
+    return INT_MAX;
+}
+
+// ============ Round Robin ============
+PCB* RoundRobinPolicy::pop() {
+    if (queue.empty()) return nullptr;
+    PCB* process = queue.front();
+    queue.pop_front();
+    return process;
+}
+
+// ============ Shortest Remaining Job ============
+// A queued process does not run, so its key cannot change while it is
+// in the heap.
+void ShortestRemainingPolicy::push(PCB* process) {
+    heap.push({ process->expanded_length - process->executed, process->pid, process });
+}
+
+PCB* ShortestRemainingPolicy::pop() {
+    if (heap.empty()) return nullptr;
+    PCB* process = heap.top().process;
+    heap.pop();
+    return process;
+}
+
+bool ShortestRemainingPolicy::sliceExpired(PCB* process) {
+    if (heap.empty()) return false;
+    return heap.top().remaining < process->expanded_length - process->executed;
+}
+
+// ============ Multilevel Feedback Queue ============
+void MLFQPolicy::push(PCB* process) {
+    int level = std::min(std::max(process->sched_level, 0), kLevels - 1);
+    levels[level].push_back(process);
+    count++;
+}
+
+PCB* MLFQPolicy::pop() {
+    if (count == 0) return nullptr;
+
+    // Priority boost: splicing whole lists is O(1); each process picks up
+    // its new level when it is popped below.
+    if (++dispatches >= kBoostInterval) {
+        dispatches = 0;
+        for (int i = 1; i < kLevels; i++) {
+            levels[0].splice(levels[0].end(), levels[i]);
+        }
+    }
+
+    for (int i = 0; i < kLevels; i++) {
+        if (!levels[i].empty()) {
+            PCB* process = levels[i].front();
+            levels[i].pop_front();
+            process->sched_level = i;
+            count--;
+            return process;
+        }
+    }
+    return nullptr;
+}
+
+int MLFQPolicy::timeSlice(const PCB* process) const {
+    return quantum << std::min(std::max(process->sched_level, 0), kLevels - 1);
+}
+
+bool MLFQPolicy::sliceExpired(PCB* process) {
+    process->sched_level = std::min(process->sched_level + 1, kLevels - 1);
+    return true;
+}
+
+std::unique_ptr<SchedulingPolicy> makeSchedulingPolicy(const std::string& name, int quantum) {
+    quantum = std::max(1, quantum);
+
+    if (name == "fcfs") return std::make_unique<FCFSPolicy>();
+    if (name == "rr") return std::make_unique<RoundRobinPolicy>(quantum);
+    if (name == "sjf" || name == "srtf") return std::make_unique<ShortestRemainingPolicy>(quantum);
+    if (name == "mlfq") return std::make_unique<MLFQPolicy>(quantum);
+    return nullptr;
+}
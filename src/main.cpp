@@ -2,6 +2,7 @@
 #include "../include/Scheduler.h"
 #include "../include/Process.h"
 #include "../include/CommandHandler.h"
+#include "../include/MemoryManager.h"
 #include <iostream>
 #include <thread>
 #include <chrono>
@@ -67,6 +68,7 @@ int main() {
     }
 
     pm.cleanup();
+    MemoryManager::getInstance().shutdown();
 
     std::cout << "Cleanup complete. Exiting." << std::endl;
     return 0;